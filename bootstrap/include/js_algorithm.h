@@ -0,0 +1,153 @@
+#pragma once
+
+#include <emscripten/val.h>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include "algorithm.h"
+#include "explicit_cast.h"
+#include "range_defines.h"
+#include "js_types.h"
+#include "js_bootstrap.h"
+#include "js_marshal_detail.h"
+#include "tc_move.h"
+
+// Algorithms on tc::js::Array and tc::js::ReadonlyArray which run as a single loop in JS and only return the result.
+// Iterating a JS array from C++, even in chunks, copies every element into wasm memory; these do not.
+// Predicates are limited to comparisons which can be evaluated in JS, see tc::jst::js_pred.
+// tc::accumulate(jarr, dbl, fn_assign_plus()) on a number array also pushes down, see below. tc::find_first_if does not:
+// its RangeReturn policies return iterators into the range, which a loop in JS cannot produce, so a search with a js_pred is
+// spelled tc::jst::find_first_if and returns the element. Any other tc:: algorithm iterates the JS array element by element.
+namespace tc::jst {
+// Order has to match tc_js_algorithm_detail_js_MakePredicate in js_algorithm.js.
+enum class EJsPredicate {
+	equal_to,
+	not_equal_to,
+	less,
+	less_equal,
+	greater,
+	greater_equal,
+	truthy
+};
+
+namespace no_adl {
+struct js_predicate final {
+	js_predicate(EJsPredicate epred, emscripten::val emvalValue) noexcept
+		: m_epred(epred)
+		, m_emvalValue(tc_move(emvalValue))
+	{}
+
+	EJsPredicate m_epred;
+	emscripten::val m_emvalValue;
+	std::string m_strProperty; // empty: the predicate is applied to the element itself
+};
+} // namespace no_adl
+using no_adl::js_predicate;
+
+namespace js_pred {
+	// Comparisons use JS semantics, equality is ===.
+	template<typename T>
+	js_predicate equal_to(T const& value) noexcept { return js_predicate(EJsPredicate::equal_to, emscripten::val(value)); }
+	template<typename T>
+	js_predicate not_equal_to(T const& value) noexcept { return js_predicate(EJsPredicate::not_equal_to, emscripten::val(value)); }
+	template<typename T>
+	js_predicate less(T const& value) noexcept { return js_predicate(EJsPredicate::less, emscripten::val(value)); }
+	template<typename T>
+	js_predicate less_equal(T const& value) noexcept { return js_predicate(EJsPredicate::less_equal, emscripten::val(value)); }
+	template<typename T>
+	js_predicate greater(T const& value) noexcept { return js_predicate(EJsPredicate::greater, emscripten::val(value)); }
+	template<typename T>
+	js_predicate greater_equal(T const& value) noexcept { return js_predicate(EJsPredicate::greater_equal, emscripten::val(value)); }
+	inline js_predicate truthy() noexcept { return js_predicate(EJsPredicate::truthy, emscripten::val::undefined()); }
+
+	// Applies pred to the property strName of each element, e.g. to filter objects by property value.
+	inline js_predicate property(std::string strName, js_predicate pred) noexcept {
+		_ASSERT(tc::empty(pred.m_strProperty));
+		_ASSERT(!tc::empty(strName));
+		pred.m_strProperty = tc_move(strName);
+		return pred;
+	}
+}
+
+namespace algorithm_detail {
+template<typename JsArray>
+struct JsArrayValueType {};
+
+template<typename T>
+struct JsArrayValueType<tc::js::Array<T>> { using type = T; };
+
+template<typename T>
+struct JsArrayValueType<tc::js::ReadonlyArray<T>> { using type = T; };
+
+template<typename JsArray>
+using JsArrayValueType_t = typename JsArrayValueType<tc::remove_cvref_t<JsArray>>::type;
+
+template<typename JsArray>
+using IsJsNumberArray = range_detail::IsArrayReadAsNumber<JsArrayValueType_t<JsArray>>;
+} // namespace algorithm_detail
+
+template<typename JsArray, std::enable_if_t<algorithm_detail::IsJsNumberArray<JsArray>::value>* = nullptr>
+double sum(JsArray const& jarr) noexcept {
+	static auto const fnSum = marshal_detail::LookupModuleFunction("tc_js_algorithm_detail_js_Sum", "js_algorithm.js");
+	return fnSum(jarr).template as<double>();
+}
+
+template<typename JsArray, std::enable_if_t<algorithm_detail::IsJsNumberArray<JsArray>::value>* = nullptr>
+std::optional<algorithm_detail::JsArrayValueType_t<JsArray>> min(JsArray const& jarr) noexcept {
+	static auto const fnMin = marshal_detail::LookupModuleFunction("tc_js_algorithm_detail_js_Min", "js_algorithm.js");
+	auto const emval = fnMin(jarr);
+	if(emval.isUndefined()) {
+		return std::nullopt;
+	}
+	return emval.template as<algorithm_detail::JsArrayValueType_t<JsArray>>();
+}
+
+template<typename JsArray, std::enable_if_t<algorithm_detail::IsJsNumberArray<JsArray>::value>* = nullptr>
+std::optional<algorithm_detail::JsArrayValueType_t<JsArray>> max(JsArray const& jarr) noexcept {
+	static auto const fnMax = marshal_detail::LookupModuleFunction("tc_js_algorithm_detail_js_Max", "js_algorithm.js");
+	auto const emval = fnMax(jarr);
+	if(emval.isUndefined()) {
+		return std::nullopt;
+	}
+	return emval.template as<algorithm_detail::JsArrayValueType_t<JsArray>>();
+}
+
+template<typename JsArray, typename T = algorithm_detail::JsArrayValueType_t<JsArray>>
+int count_if(JsArray const& jarr, js_predicate const& pred) noexcept {
+	static auto const fnCountIf = marshal_detail::LookupModuleFunction("tc_js_algorithm_detail_js_CountIf", "js_algorithm.js");
+	return fnCountIf(jarr, static_cast<int>(pred.m_epred), pred.m_emvalValue, pred.m_strProperty).template as<int>();
+}
+
+template<typename JsArray, typename T = algorithm_detail::JsArrayValueType_t<JsArray>>
+std::optional<T> find_first_if(JsArray const& jarr, js_predicate const& pred) noexcept {
+	static auto const fnFindFirstIndexIf = marshal_detail::LookupModuleFunction("tc_js_algorithm_detail_js_FindFirstIndexIf", "js_algorithm.js");
+	int const i = fnFindFirstIndexIf(jarr, static_cast<int>(pred.m_epred), pred.m_emvalValue, pred.m_strProperty).template as<int>();
+	if(i < 0) {
+		return std::nullopt;
+	}
+	return jarr.getEmval()[i].template as<T>();
+}
+
+// Returns a new JS array, the elements are not copied into wasm memory.
+template<typename JsArray, typename T = algorithm_detail::JsArrayValueType_t<JsArray>>
+tc::js::Array<T> filter(JsArray const& jarr, js_predicate const& pred) noexcept {
+	static auto const fnFilter = marshal_detail::LookupModuleFunction("tc_js_algorithm_detail_js_Filter", "js_algorithm.js");
+	return tc::js::Array<T>(fnFilter(jarr, static_cast<int>(pred.m_epred), pred.m_emvalValue, pred.m_strProperty));
+}
+
+// Returns a new JS array of the property strName of each element.
+template<typename U, typename JsArray, typename = algorithm_detail::JsArrayValueType_t<JsArray>>
+tc::js::Array<U> transform_property(JsArray const& jarr, std::string const& strName) noexcept {
+	static auto const fnMapProperty = marshal_detail::LookupModuleFunction("tc_js_algorithm_detail_js_MapProperty", "js_algorithm.js");
+	return tc::js::Array<U>(fnMapProperty(jarr, strName));
+}
+} // namespace tc::jst
+
+namespace tc {
+// More specialized than the generic tc::accumulate, so summing a JS number array with the usual spelling runs as tc::jst::sum.
+template<typename JsArray, std::enable_if_t<jst::algorithm_detail::IsJsNumberArray<JsArray>::value>* = nullptr>
+double accumulate(JsArray&& jarr, double dbl, fn_assign_plus) noexcept {
+	return dbl + jst::sum(jarr);
+}
+} // namespace tc
@@ -1,18 +1,546 @@
 #pragma once
 
 #include <emscripten/val.h>
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
 #include <utility>
+#include <tuple>
 #include <type_traits>
+#include <vector>
 #include "break_or_continue.h"
 #include "explicit_cast.h"
+#include "noncopyable.h"
 #include "type_traits.h"
 #include "range.h"
 #include "js_types.h"
 #include "js_callback.h"
+#include "js_marshal_detail.h"
 #include "tc_move.h"
 
+#include <boost/preprocessor/seq/enum.hpp>
+#include <boost/preprocessor/seq/for_each.hpp>
+#include <boost/preprocessor/stringize.hpp>
+#include <boost/preprocessor/variadic/to_seq.hpp>
 #include <boost/range/iterator.hpp>
 
+namespace tc::jst::range_detail {
+// Iterating over Array/ReadonlyArray copies elements into wasm memory in chunks instead of crossing into JS for every element.
+// Numbers, booleans and integral enums are copied as doubles, other wrapped JS values as handles.
+// A chunk is read when one of its elements is accessed first and is kept while it is cached. Modifications of the JS array
+// made in the meantime, through the iterators' array or otherwise, are not observed for the elements of cached chunks.
+// Iterators must not be used after modifying the array anyway, like iterators of a std::vector.
+inline constexpr int c_nArrayChunkSize = 1024;
+// Chunks cached by the copies of an iterator, so that e.g. the two iterators of a reverse algorithm or a binary search
+// do not evict each other's chunk on every access.
+inline constexpr int c_nArrayChunksCached = 4;
+
+template<typename T>
+using IsArrayReadAsNumber = std::disjunction<std::is_same<T, double>, std::is_same<T, bool>, IsJsIntegralEnum<T>>;
+
+template<typename T>
+using IsArrayReadAsHandle = std::conjunction<std::negation<IsArrayReadAsNumber<T>>, emscripten_interop_detail::IsEmvalWrapper<T>>;
+
+template<typename T>
+using IsArrayReadInChunks = std::disjunction<IsArrayReadAsNumber<T>, IsArrayReadAsHandle<T>>;
+
+template<typename T>
+T FromArrayNumber(double dbl) noexcept {
+	if constexpr(std::is_same<T, double>::value) {
+		return dbl;
+	} else if constexpr(std::is_same<T, bool>::value) {
+		return 0 != dbl;
+	} else {
+		return static_cast<T>(tc::explicit_cast<std::underlying_type_t<T>>(dbl));
+	}
+}
+
+namespace no_adl {
+template<typename T>
+struct CArrayChunk final : private tc::noncopyable {
+	static_assert(IsArrayReadInChunks<T>::value);
+
+	bool Contains(int i) const& noexcept { return m_iBegin <= i && i < m_iEnd; }
+	bool Before(int i) const& noexcept { return m_iBegin < m_iEnd && i < m_iBegin; }
+
+	T const& operator[](int i) const& noexcept {
+		_ASSERT(Contains(i));
+		return m_vect[i - m_iBegin];
+	}
+
+	void Read(emscripten::val const& emvalArray, int iBegin) & noexcept {
+		m_iBegin = iBegin;
+		m_vect.clear();
+		marshal_detail::CArenaScope scope;
+		if constexpr(IsArrayReadAsNumber<T>::value) {
+			static auto const fnReadNumbers = marshal_detail::LookupModuleFunction("tc_js_marshal_detail_js_ReadNumbers");
+			auto const spandbl = marshal_detail::ArenaSpan<double>(c_nArrayChunkSize);
+			int const n = fnReadNumbers(emvalArray, iBegin, reinterpret_cast<marshal_detail::PointerNumber>(spandbl.data()), c_nArrayChunkSize).template as<int>();
+			for(int i = 0; i < n; ++i) {
+				m_vect.emplace_back(FromArrayNumber<T>(spandbl[i]));
+			}
+		} else {
+			static auto const fnReadHandles = marshal_detail::LookupModuleFunction("tc_js_marshal_detail_js_ReadHandles");
+			auto const spanh = marshal_detail::ArenaSpan<std::uint32_t>(c_nArrayChunkSize);
+			int const n = fnReadHandles(emvalArray, iBegin, reinterpret_cast<marshal_detail::PointerNumber>(spanh.data()), c_nArrayChunkSize).template as<int>();
+			for(int i = 0; i < n; ++i) {
+				m_vect.emplace_back(marshal_detail::TakeHandle(spanh[i]));
+			}
+		}
+		m_iEnd = m_iBegin + tc::explicit_cast<int>(tc::size(m_vect));
+	}
+
+private:
+	int m_iBegin = 0;
+	int m_iEnd = 0;
+	std::vector<T> m_vect;
+};
+
+// Shared by the copies of an iterator, so copying iterators, which algorithms do freely, does not copy elements.
+template<typename T>
+struct CArrayChunkCache final : private tc::noncopyable {
+	T Get(emscripten::val const& emvalArray, int i) & noexcept {
+		auto const itchunk = std::find_if(m_achunk.begin(), m_achunk.end(), [&](CArrayChunk<T> const& chunk) noexcept {
+			return chunk.Contains(i);
+		});
+		std::size_t iChunk;
+		if(m_achunk.end() != itchunk) {
+			iChunk = itchunk - m_achunk.begin();
+		} else {
+			// Replace the least recently used chunk. When iterating backwards, read the chunk which ends at i.
+			iChunk = std::min_element(m_anLastUse.begin(), m_anLastUse.end()) - m_anLastUse.begin();
+			bool const bBackwards = m_achunk[m_iChunkLastUsed].Before(i);
+			m_achunk[iChunk].Read(emvalArray, bBackwards ? std::max(0, i + 1 - c_nArrayChunkSize) : i);
+			_ASSERT(m_achunk[iChunk].Contains(i));
+		}
+		m_anLastUse[iChunk] = ++m_nUse;
+		m_iChunkLastUsed = iChunk;
+		return m_achunk[iChunk][i];
+	}
+
+private:
+	std::array<CArrayChunk<T>, c_nArrayChunksCached> m_achunk;
+	std::array<std::uint64_t, c_nArrayChunksCached> m_anLastUse{};
+	std::uint64_t m_nUse = 0;
+	std::size_t m_iChunkLastUsed = 0;
+};
+} // namespace no_adl
+using no_adl::CArrayChunk;
+using no_adl::CArrayChunkCache;
+
+template<typename T>
+double ToArrayNumber(T const& t) noexcept {
+	if constexpr(std::is_same<T, double>::value) {
+		return t;
+	} else if constexpr(std::is_same<T, bool>::value) {
+		return t ? 1 : 0;
+	} else {
+		return tc::explicit_cast<double>(static_cast<std::underlying_type_t<T>>(t));
+	}
+}
+
+// Reads at most n elements from a JS iterator with a single call into JS. Fewer elements are returned only if the iterator is done.
+template<typename T>
+std::vector<T> ReadIterator(emscripten::val const& emvalIterator, int n) noexcept {
+	std::vector<T> vect;
+	if constexpr(IsArrayReadAsNumber<T>::value) {
+		static auto const fnReadIteratorNumbers = marshal_detail::LookupModuleFunction("tc_js_marshal_detail_js_ReadIteratorNumbers");
+		marshal_detail::CArenaScope scope;
+		auto const spandbl = marshal_detail::ArenaSpan<double>(n);
+		auto const nRead = fnReadIteratorNumbers(emvalIterator, reinterpret_cast<marshal_detail::PointerNumber>(spandbl.data()), n).template as<std::size_t>();
+		vect.reserve(nRead);
+		tc::for_each(spandbl.first(nRead), [&](double dbl) noexcept {
+			vect.emplace_back(FromArrayNumber<T>(dbl));
+		});
+	} else if constexpr(IsArrayReadAsHandle<T>::value) {
+		static auto const fnReadIteratorHandles = marshal_detail::LookupModuleFunction("tc_js_marshal_detail_js_ReadIteratorHandles");
+		marshal_detail::CArenaScope scope;
+		auto const spanh = marshal_detail::ArenaSpan<std::uint32_t>(n);
+		auto const nRead = fnReadIteratorHandles(emvalIterator, reinterpret_cast<marshal_detail::PointerNumber>(spanh.data()), n).template as<std::size_t>();
+		vect.reserve(nRead);
+		tc::for_each(spanh.first(nRead), [&](std::uint32_t h) noexcept {
+			vect.emplace_back(marshal_detail::TakeHandle(h));
+		});
+	} else {
+		for(int i = 0; i < n; ++i) {
+			emscripten::val const emvalResult = emvalIterator.call<emscripten::val>("next");
+			if(emvalResult["done"].template as<bool>()) {
+				break;
+			}
+			vect.emplace_back(emvalResult["value"].template as<T>());
+		}
+	}
+	return vect;
+}
+
+namespace no_adl {
+// Input iterator over a JS iterator which reads elements in chunks. Copies share the position, like std::istream_iterator.
+// The default constructed iterator is the end iterator.
+template<typename T>
+struct js_iterator_chunked final {
+	using iterator_category = std::input_iterator_tag;
+	using value_type = T;
+	using difference_type = std::ptrdiff_t;
+	using pointer = void;
+	using reference = T const&;
+
+	js_iterator_chunked() noexcept = default;
+
+	js_iterator_chunked(emscripten::val emvalIterator, int nChunkSize) noexcept
+		: m_pstate(std::make_shared<SState>(tc_move(emvalIterator), nChunkSize))
+	{
+		_ASSERT(0 < nChunkSize);
+	}
+
+	T const& operator*() const& noexcept {
+		_ASSERT(!AtEnd());
+		return m_pstate->m_vect[m_pstate->m_i];
+	}
+
+	js_iterator_chunked& operator++() & noexcept {
+		_ASSERT(!AtEnd());
+		++m_pstate->m_i;
+		return *this;
+	}
+
+	void operator++(int) & noexcept { ++*this; }
+
+	friend bool operator==(js_iterator_chunked const& lhs, js_iterator_chunked const& rhs) noexcept {
+		return lhs.AtEnd() == rhs.AtEnd() && (lhs.AtEnd() || lhs.m_pstate == rhs.m_pstate);
+	}
+	friend bool operator!=(js_iterator_chunked const& lhs, js_iterator_chunked const& rhs) noexcept {
+		return !(lhs == rhs);
+	}
+
+private:
+	struct SState final : private tc::noncopyable {
+		SState(emscripten::val emvalIterator, int nChunkSize) noexcept
+			: m_emvalIterator(tc_move(emvalIterator))
+			, m_nChunkSize(nChunkSize)
+		{}
+
+		emscripten::val m_emvalIterator;
+		int m_nChunkSize;
+		std::vector<T> m_vect;
+		std::size_t m_i = 0;
+		bool m_bDone = false;
+	};
+	std::shared_ptr<SState> m_pstate;
+
+	bool AtEnd() const& noexcept {
+		if(!m_pstate) {
+			return true;
+		}
+		if(m_pstate->m_i == tc::size(m_pstate->m_vect) && !m_pstate->m_bDone) {
+			m_pstate->m_vect = ReadIterator<T>(m_pstate->m_emvalIterator, m_pstate->m_nChunkSize);
+			m_pstate->m_i = 0;
+			m_pstate->m_bDone = tc::size(m_pstate->m_vect) < tc::explicit_cast<std::size_t>(m_pstate->m_nChunkSize);
+		}
+		return m_pstate->m_i == tc::size(m_pstate->m_vect);
+	}
+};
+
+// Single pass range over a JS iterator. Iterating again continues where the last iteration stopped.
+template<typename T>
+struct js_iterable_range final {
+	js_iterable_range(emscripten::val emvalIterator, int nChunkSize) noexcept
+		: m_itBegin(tc_move(emvalIterator), nChunkSize)
+	{}
+
+	js_iterator_chunked<T> begin() const& noexcept { return m_itBegin; }
+	js_iterator_chunked<T> end() const& noexcept { return {}; }
+
+private:
+	js_iterator_chunked<T> m_itBegin;
+};
+} // namespace no_adl
+using no_adl::js_iterator_chunked;
+using no_adl::js_iterable_range;
+
+// Reads a buffer created by tc_js_marshal_detail_js_EncodeNumbers or tc_js_marshal_detail_js_EncodeHandles.
+// The buffer lives in the arena, so the caller must call JS and decode within the same CArenaScope.
+template<typename T>
+std::vector<T> DecodeBuffer(marshal_detail::PointerNumber p) noexcept {
+	static_assert(IsArrayReadInChunks<T>::value);
+	std::uint32_t const* const pn = reinterpret_cast<std::uint32_t const*>(p);
+	std::uint32_t const n = pn[0];
+	std::vector<T> vect;
+	vect.reserve(n);
+	if constexpr(IsArrayReadAsNumber<T>::value) {
+		double const* const pdbl = reinterpret_cast<double const*>(pn + 2);
+		for(std::uint32_t i = 0; i < n; ++i) {
+			vect.emplace_back(FromArrayNumber<T>(pdbl[i]));
+		}
+	} else {
+		for(std::uint32_t i = 0; i < n; ++i) {
+			vect.emplace_back(marshal_detail::TakeHandle(pn[1 + i]));
+		}
+	}
+	return vect;
+}
+
+// Reads a slot written by tc_js_marshal_detail_js_ReadMapEntries: a double, or a handle in its first 4 bytes.
+template<typename T>
+T ReadMapEntrySlot(std::uint32_t const* pnSlot) noexcept {
+	if constexpr(IsArrayReadAsNumber<T>::value) {
+		return FromArrayNumber<T>(*reinterpret_cast<double const*>(pnSlot));
+	} else {
+		return T(marshal_detail::TakeHandle(*pnSlot));
+	}
+}
+
+// Copies all entries of a JS Map with a single call into JS.
+template<typename K, typename V>
+std::vector<std::pair<K, V>> ReadMapEntries(emscripten::val const& emvalMap) noexcept {
+	static_assert(IsArrayReadInChunks<K>::value && IsArrayReadInChunks<V>::value);
+	static auto const fnReadMapEntries = marshal_detail::LookupModuleFunction("tc_js_marshal_detail_js_ReadMapEntries");
+	marshal_detail::CArenaScope scope;
+	std::uint32_t const* const pn = reinterpret_cast<std::uint32_t const*>(
+		fnReadMapEntries(emvalMap, IsArrayReadAsNumber<K>::value, IsArrayReadAsNumber<V>::value).template as<marshal_detail::PointerNumber>()
+	);
+	std::uint32_t const n = pn[0];
+	std::vector<std::pair<K, V>> vecpairkv;
+	vecpairkv.reserve(n);
+	for(std::uint32_t i = 0; i < n; ++i) {
+		vecpairkv.emplace_back(ReadMapEntrySlot<K>(pn + 2 + 2 * i), ReadMapEntrySlot<V>(pn + 2 + 2 * (n + i)));
+	}
+	return vecpairkv;
+}
+
+// Must match tc_js_marshal_detail_js_DecodeArray.
+enum class EArrayEncoding { number, boolean, handle, utf8 };
+
+// Collects elements of a C++ range to be passed to tc_js_marshal_detail_js_DecodeArray.
+// Strings given as UTF-8 are passed as such, so no JS string has to be created per element by C++.
+// The elements are stored in the arena, so the caller must call JS within the same CArenaScope.
+template<typename T, typename Value>
+struct CEncodedArray final : private tc::noncopyable {
+	static constexpr bool c_bUtf8 = std::is_same<T, js_string>::value && std::is_convertible<Value, std::string_view>::value;
+	static_assert(c_bUtf8 || IsArrayReadInChunks<T>::value);
+
+	template<typename ValueSrc>
+	void Append(ValueSrc&& value) & noexcept {
+		++m_n;
+		if constexpr(c_bUtf8) {
+			std::string_view const sv(std::forward<ValueSrc>(value));
+			m_vecn.push_back(tc::explicit_cast<std::uint32_t>(m_vecch.size()));
+			m_vecch.append(sv.data(), tc::size(sv));
+		} else if constexpr(IsArrayReadAsNumber<T>::value) {
+			m_vecdbl.push_back(ToArrayNumber(tc::explicit_cast<T>(std::forward<ValueSrc>(value))));
+		} else {
+			m_vecn.push_back(marshal_detail::ReleaseHandle(tc::explicit_cast<T>(std::forward<ValueSrc>(value)).getEmval()));
+		}
+	}
+
+	int Encoding() const& noexcept {
+		if constexpr(c_bUtf8) {
+			return static_cast<int>(EArrayEncoding::utf8);
+		} else if constexpr(std::is_same<T, bool>::value) {
+			return static_cast<int>(EArrayEncoding::boolean);
+		} else if constexpr(IsArrayReadAsNumber<T>::value) {
+			return static_cast<int>(EArrayEncoding::number);
+		} else {
+			return static_cast<int>(EArrayEncoding::handle);
+		}
+	}
+
+	int size() const& noexcept { return m_n; }
+
+	// Call only once, directly before the call into JS.
+	marshal_detail::PointerNumber Pointer() & noexcept {
+		if constexpr(c_bUtf8) {
+			// The last offset is the total length.
+			m_vecn.push_back(tc::explicit_cast<std::uint32_t>(m_vecch.size()));
+			return m_vecn.Pointer();
+		} else if constexpr(IsArrayReadAsNumber<T>::value) {
+			return m_vecdbl.Pointer();
+		} else {
+			return m_vecn.Pointer();
+		}
+	}
+
+	marshal_detail::PointerNumber PointerChars() const& noexcept {
+		return m_vecch.Pointer();
+	}
+
+private:
+	int m_n = 0;
+	marshal_detail::CArenaVector<double> m_vecdbl;
+	marshal_detail::CArenaVector<std::uint32_t> m_vecn; // handles owned by JS or UTF-8 offsets
+	marshal_detail::CArenaVector<char> m_vecch;
+};
+
+// Replaces nDelete elements starting at iStart by the elements of rng. Numbers, booleans and integral enums
+// are passed as doubles in the arena, other wrapped JS values as handles, so it is a single call into JS.
+template<typename T, typename Rng>
+void SpliceArray(emscripten::val const& emvalArray, int iStart, int nDelete, Rng&& rng) noexcept {
+	if constexpr(IsArrayReadInChunks<T>::value) {
+		marshal_detail::CArenaScope scope;
+		CEncodedArray<T, T> enc;
+		tc::for_each(std::forward<Rng>(rng), [&](auto&& value) noexcept {
+			enc.Append(std::forward<decltype(value)>(value));
+		});
+		if constexpr(IsArrayReadAsNumber<T>::value) {
+			static auto const fnSpliceNumbers = marshal_detail::LookupModuleFunction("tc_js_marshal_detail_js_SpliceNumbers");
+			fnSpliceNumbers(emvalArray, iStart, nDelete, enc.Pointer(), enc.size(), std::is_same<T, bool>::value);
+		} else {
+			static auto const fnSpliceHandles = marshal_detail::LookupModuleFunction("tc_js_marshal_detail_js_SpliceHandles");
+			fnSpliceHandles(emvalArray, iStart, nDelete, enc.Pointer(), enc.size());
+		}
+	} else {
+		emvalArray.call<void>("splice", iStart, nDelete);
+		tc::for_each(std::forward<Rng>(rng), [&](auto&& value) noexcept {
+			emvalArray.call<void>("splice", iStart, 0, tc::explicit_cast<T>(std::forward<decltype(value)>(value)));
+			++iStart;
+		});
+	}
+}
+} // namespace tc::jst::range_detail
+
+namespace tc::jst::struct_detail {
+// C++ structs are passed to JS packed into wasm memory and decoded by a JS function compiled once per struct type,
+// so creating N objects is a single call into JS instead of one call per field and element.
+// The fields are listed by TC_JS_STRUCT or, for the snapshot_type of interfaces tagged with @tcjsSnapshot, by stage1.
+// Arithmetic types and integral enums are packed as numbers, types convertible to std::string_view as UTF-8,
+// other JS interoperable types as handles.
+namespace no_adl {
+template<typename Struct, typename M>
+struct SField final {
+	using value_type = M;
+	char const* m_szName;
+	M Struct::* m_pm;
+};
+
+template<typename T, typename = void>
+struct IsJsStruct : std::false_type {};
+
+// _tcjs_struct_fields is found by argument-dependent lookup, see TC_JS_STRUCT.
+template<typename T>
+struct IsJsStruct<T, tc::void_t<decltype(_tcjs_struct_fields(static_cast<T const*>(nullptr)))>> : std::true_type {};
+} // namespace no_adl
+using no_adl::SField;
+using no_adl::IsJsStruct;
+
+template<typename Struct, typename M>
+constexpr SField<Struct, M> field(char const* szName, M Struct::* pm) noexcept {
+	return {szName, pm};
+}
+
+template<typename M>
+inline constexpr range_detail::EArrayEncoding c_earrencField =
+	std::is_same<M, bool>::value ? range_detail::EArrayEncoding::boolean
+	: std::is_arithmetic<M>::value || IsJsIntegralEnum<M>::value ? range_detail::EArrayEncoding::number
+	: std::is_convertible<M const&, std::string_view>::value ? range_detail::EArrayEncoding::utf8
+	: range_detail::EArrayEncoding::handle;
+
+namespace no_adl {
+// Fields are stored row by row in the arena: numbers and booleans in m_vecdbl, handles owned by JS in m_vech
+// and strings as offsets into m_vecch.
+template<typename Struct>
+struct CPackedStructs final : private tc::noncopyable {
+	static_assert(IsJsStruct<Struct>::value, "Struct must be listed with TC_JS_STRUCT");
+
+	template<typename Rng>
+	explicit CPackedStructs(Rng&& rng) noexcept {
+		auto const tplfield = _tcjs_struct_fields(static_cast<Struct const*>(nullptr));
+		tc::for_each(std::forward<Rng>(rng), [&](Struct const& s) noexcept {
+			++m_n;
+			std::apply([&](auto const&... field) noexcept {
+				(Append(s.*field.m_pm), ...);
+			}, tplfield);
+		});
+	}
+
+	// szDecode is "rows" for an array with one object per element or "columns" for an object with one array per field.
+	emscripten::val Decode(char const* szDecode) & noexcept {
+		static auto const emvalDecoder = CreateDecoder();
+		m_vecnOffset.push_back(tc::explicit_cast<std::uint32_t>(m_vecch.size())); // The last offset is the total length.
+		return emvalDecoder.call<emscripten::val>(szDecode, m_n, m_vecdbl.Pointer(), m_vech.Pointer(), m_vecnOffset.Pointer(), m_vecch.Pointer());
+	}
+
+private:
+	marshal_detail::CArenaScope m_scope; // First member, so the arena is released after the buffers are destroyed.
+	int m_n = 0;
+	marshal_detail::CArenaVector<double> m_vecdbl;
+	marshal_detail::CArenaVector<std::uint32_t> m_vech;
+	marshal_detail::CArenaVector<std::uint32_t> m_vecnOffset;
+	marshal_detail::CArenaVector<char> m_vecch;
+
+	template<typename M>
+	void Append(M const& m) & noexcept {
+		if constexpr(std::is_arithmetic<M>::value) {
+			m_vecdbl.push_back(static_cast<double>(m));
+		} else if constexpr(IsJsIntegralEnum<M>::value) {
+			m_vecdbl.push_back(range_detail::ToArrayNumber(m));
+		} else if constexpr(range_detail::EArrayEncoding::utf8 == c_earrencField<M>) {
+			std::string_view const sv(m);
+			m_vecnOffset.push_back(tc::explicit_cast<std::uint32_t>(m_vecch.size()));
+			m_vecch.append(sv.data(), tc::size(sv));
+		} else {
+			static_assert(IsJsInteropable<M>::value);
+			m_vech.push_back(marshal_detail::ReleaseHandle(emscripten::val(m)));
+		}
+	}
+
+	static emscripten::val CreateDecoder() noexcept {
+		static auto const fnCreateStructDecoder = marshal_detail::LookupModuleFunction("tc_js_marshal_detail_js_CreateStructDecoder");
+		emscripten::val emvalNames = emscripten::val::array();
+		std::vector<int> veciEncoding;
+		std::apply([&](auto const&... field) noexcept {
+			(emvalNames.call<void>("push", emscripten::val(field.m_szName)), ...);
+			(veciEncoding.emplace_back(static_cast<int>(c_earrencField<typename tc::remove_cvref_t<decltype(field)>::value_type>)), ...);
+		}, _tcjs_struct_fields(static_cast<Struct const*>(nullptr)));
+		return fnCreateStructDecoder(emvalNames, emscripten::typed_memory_view(tc::size(veciEncoding), veciEncoding.data()));
+	}
+};
+} // namespace no_adl
+using no_adl::CPackedStructs;
+} // namespace tc::jst::struct_detail
+
+// Lists the fields of a C++ struct which are passed to JS as properties of the same name, e.g.,
+// struct SDataPoint { double x; double y; std::string label; };
+// TC_JS_STRUCT(SDataPoint, x, y, label)
+// Must be used in the namespace of the struct.
+#define TC_JS_STRUCT_FIELD(r, Struct, Field) (::tc::jst::struct_detail::field(BOOST_PP_STRINGIZE(Field), &Struct::Field))
+#define TC_JS_STRUCT(Struct, ...) \
+	[[maybe_unused]] inline auto _tcjs_struct_fields(Struct const*) noexcept { \
+		return std::make_tuple(BOOST_PP_SEQ_ENUM(BOOST_PP_SEQ_FOR_EACH(TC_JS_STRUCT_FIELD, Struct, BOOST_PP_VARIADIC_TO_SEQ(__VA_ARGS__)))); \
+	}
+
+namespace tc::jst {
+namespace no_adl {
+template<typename T> struct js_async_chunk_reader;
+} // namespace no_adl
+using no_adl::js_async_chunk_reader;
+} // namespace tc::jst
+
+namespace tc::jst::typed_array_detail {
+// Element types of JS typed arrays, as far as they correspond to a single C++ type.
+// Uint8ClampedArray is omitted because it has the same element type as Uint8Array.
+template<typename T> struct STypedArrayName;
+template<> struct STypedArrayName<std::int8_t> { static constexpr char const* c_szArray = "Int8Array"; static constexpr char const* c_szGet = "getInt8"; static constexpr char const* c_szSet = "setInt8"; };
+template<> struct STypedArrayName<std::uint8_t> { static constexpr char const* c_szArray = "Uint8Array"; static constexpr char const* c_szGet = "getUint8"; static constexpr char const* c_szSet = "setUint8"; };
+template<> struct STypedArrayName<std::int16_t> { static constexpr char const* c_szArray = "Int16Array"; static constexpr char const* c_szGet = "getInt16"; static constexpr char const* c_szSet = "setInt16"; };
+template<> struct STypedArrayName<std::uint16_t> { static constexpr char const* c_szArray = "Uint16Array"; static constexpr char const* c_szGet = "getUint16"; static constexpr char const* c_szSet = "setUint16"; };
+template<> struct STypedArrayName<std::int32_t> { static constexpr char const* c_szArray = "Int32Array"; static constexpr char const* c_szGet = "getInt32"; static constexpr char const* c_szSet = "setInt32"; };
+template<> struct STypedArrayName<std::uint32_t> { static constexpr char const* c_szArray = "Uint32Array"; static constexpr char const* c_szGet = "getUint32"; static constexpr char const* c_szSet = "setUint32"; };
+template<> struct STypedArrayName<float> { static constexpr char const* c_szArray = "Float32Array"; static constexpr char const* c_szGet = "getFloat32"; static constexpr char const* c_szSet = "setFloat32"; };
+template<> struct STypedArrayName<double> { static constexpr char const* c_szArray = "Float64Array"; static constexpr char const* c_szGet = "getFloat64"; static constexpr char const* c_szSet = "setFloat64"; };
+
+template<typename T, typename = void>
+struct IsTypedArrayElement : std::false_type {};
+
+template<typename T>
+struct IsTypedArrayElement<T, std::void_t<decltype(STypedArrayName<T>::c_szArray)>> : std::true_type {};
+} // namespace tc::jst::typed_array_detail
+
 namespace tc::js {
 
 namespace no_adl {
@@ -23,12 +551,34 @@ template<typename K, typename V> struct _js_Record;
 // TODO: Typescript Utility type https://www.typescriptlang.org/docs/handbook/utility-types.html
 
 struct _js_console;
+template<typename T> struct _js_Iterable;
+template<typename T> struct _js_AsyncIterable;
+template<typename K, typename V> struct _js_Map;
+template<typename T> struct _js_Set;
+struct _js_ArrayBuffer;
+template<typename T> struct _js_TypedArray;
+struct _js_DataView;
 
 template<typename T> using Array = ::tc::jst::js_ref<_js_Array<T>>;
 template<typename T> using ReadonlyArray = ::tc::jst::js_ref<_js_ReadonlyArray<T>>;
 template<typename T> using Promise = ::tc::jst::js_ref<_js_Promise<T>>;
 template<typename K, typename V> using Record = ::tc::jst::js_ref<_js_Record<K, V>>;
 using console = ::tc::jst::js_ref<_js_console>;
+template<typename T> using Iterable = ::tc::jst::js_ref<_js_Iterable<T>>;
+template<typename T> using AsyncIterable = ::tc::jst::js_ref<_js_AsyncIterable<T>>;
+template<typename K, typename V> using Map = ::tc::jst::js_ref<_js_Map<K, V>>;
+template<typename T> using Set = ::tc::jst::js_ref<_js_Set<T>>;
+using ArrayBuffer = ::tc::jst::js_ref<_js_ArrayBuffer>;
+template<typename T> using TypedArray = ::tc::jst::js_ref<_js_TypedArray<T>>;
+using Int8Array = TypedArray<::std::int8_t>;
+using Uint8Array = TypedArray<::std::uint8_t>;
+using Int16Array = TypedArray<::std::int16_t>;
+using Uint16Array = TypedArray<::std::uint16_t>;
+using Int32Array = TypedArray<::std::int32_t>;
+using Uint32Array = TypedArray<::std::uint32_t>;
+using Float32Array = TypedArray<float>;
+using Float64Array = TypedArray<double>;
+using DataView = ::tc::jst::js_ref<_js_DataView>;
 
 template<typename T>
 struct _js_Array : virtual ::tc::jst::IObject {
@@ -45,6 +595,18 @@ struct _js_Array : virtual ::tc::jst::IObject {
 	auto push(T const& item) noexcept { return _call<void>("push", item); }
 	void _setIndex(int i, T value) noexcept { _setProperty(i, tc_move(value)); }
 
+	// Replaces all elements by the elements of rng with a single call into JS.
+	template<typename Rng, typename = ::std::enable_if_t<::tc::is_explicit_castable<T, ::tc::range_reference_t<Rng>>::value>>
+	void assign(Rng&& rng) noexcept {
+		::tc::jst::range_detail::SpliceArray<T>(_getEmval(), 0, length(), ::std::forward<Rng>(rng));
+	}
+
+	// Like JS splice, but inserts the elements of rng with a single call into JS and does not return the removed elements.
+	template<typename Rng, typename = ::std::enable_if_t<::tc::is_explicit_castable<T, ::tc::range_reference_t<Rng>>::value>>
+	void splice(int iStart, int nDelete, Rng&& rng) noexcept {
+		::tc::jst::range_detail::SpliceArray<T>(_getEmval(), iStart, nDelete, ::std::forward<Rng>(rng));
+	}
+
 	static Array<T> _tcjs_construct() noexcept {
 		return Array<T>(::emscripten::val::array());
 	}
@@ -52,17 +614,27 @@ struct _js_Array : virtual ::tc::jst::IObject {
 	template<typename Rng, typename = ::std::enable_if_t<::tc::is_explicit_castable<T, ::tc::range_reference_t<Rng>>::value>>
 	static Array<T> _tcjs_construct(Rng&& rng) noexcept {
 		Array<T> result(::emscripten::val::array());
-		::tc::for_each(::std::forward<Rng>(rng), [&](auto&& value) noexcept {
-			result->push(::tc::explicit_cast<T>(::std::forward<decltype(value)>(value)));
-		});
+		::tc::jst::range_detail::SpliceArray<T>(result.getEmval(), 0, 0, ::std::forward<Rng>(rng));
 		return result;
 	}
+
+	// Elements which are C++ structs listed by TC_JS_STRUCT are packed into wasm memory and decoded into one object
+	// per element with a single call into JS.
+	template<typename Rng, ::std::enable_if_t<
+		!::tc::is_explicit_castable<T, ::tc::range_reference_t<Rng>>::value
+		&& ::tc::jst::struct_detail::IsJsStruct<::tc::remove_cvref_t<::tc::range_reference_t<Rng>>>::value
+	>* = nullptr>
+	static Array<T> _tcjs_construct(Rng&& rng) noexcept {
+		return Array<T>(::tc::jst::struct_detail::CPackedStructs<::tc::remove_cvref_t<::tc::range_reference_t<Rng>>>(::std::forward<Rng>(rng)).Decode("rows"));
+	}
 };
 
 template<typename T>
 struct _js_ReadonlyArray : _js_Array<T> {
 	auto push(T const& item) noexcept = delete;
 	void _setIndex(int i, T value) noexcept = delete;
+	template<typename Rng> void assign(Rng&& rng) noexcept = delete;
+	template<typename Rng> void splice(int iStart, int nDelete, Rng&& rng) noexcept = delete;
 };
 
 template<typename K, typename V>
@@ -71,6 +643,269 @@ struct _js_Record : virtual ::tc::jst::IObject {
 	static_assert(::tc::jst::IsJsInteropable<V>::value);
 
 	auto operator[](K k) noexcept { return _getProperty<V>(k); }
+
+	// keys(), values() and entries() follow the order of Object.keys. Each of keys() and values() is a single call into JS.
+	auto keys() noexcept { return Read<K>(/*bValues*/false); }
+	auto values() noexcept { return Read<V>(/*bValues*/true); }
+
+	auto entries() noexcept {
+		auto veck = keys();
+		auto vecv = values();
+		_ASSERTEQUAL(tc::size(veck), tc::size(vecv));
+		::std::vector<::std::pair<K, V>> vecpairkv;
+		vecpairkv.reserve(tc::size(veck));
+		for(::std::size_t i = 0; i < tc::size(veck); ++i) {
+			vecpairkv.emplace_back(tc_move(veck[i]), tc_move(vecv[i]));
+		}
+		return vecpairkv;
+	}
+
+	static Record<K, V> _tcjs_construct() noexcept {
+		return Record<K, V>(::emscripten::val::object());
+	}
+
+	// Creates the record from a range of pairs, e.g. a std::map, with a single call into JS.
+	// Keys given as UTF-8 strings are passed without creating a JS string per key in C++.
+	template<typename Rng, typename Pair = ::tc::remove_cvref_t<::tc::range_reference_t<Rng>>, typename = ::std::enable_if_t<
+		::tc::is_explicit_castable<V, ::std::tuple_element_t<1, Pair>>::value
+	>>
+	static Record<K, V> _tcjs_construct(Rng&& rngpairkv) noexcept {
+		using KeySrc = ::std::tuple_element_t<0, Pair>;
+		using ValueSrc = ::std::tuple_element_t<1, Pair>;
+		using EncodedKeys = ::tc::jst::range_detail::CEncodedArray<K, KeySrc>;
+		if constexpr((EncodedKeys::c_bUtf8 || ::tc::jst::range_detail::IsArrayReadInChunks<K>::value) && ::tc::jst::range_detail::IsArrayReadInChunks<V>::value) {
+			static auto const fnCreateRecord = ::tc::jst::marshal_detail::LookupModuleFunction("tc_js_marshal_detail_js_CreateRecord");
+			::tc::jst::marshal_detail::CArenaScope scope;
+			EncodedKeys enck;
+			::tc::jst::range_detail::CEncodedArray<V, ValueSrc> encv;
+			::tc::for_each(::std::forward<Rng>(rngpairkv), [&](auto&& pairkv) noexcept {
+				enck.Append(::std::get<0>(::std::forward<decltype(pairkv)>(pairkv)));
+				encv.Append(::std::get<1>(::std::forward<decltype(pairkv)>(pairkv)));
+			});
+			return Record<K, V>(fnCreateRecord(enck.size(), enck.Encoding(), enck.Pointer(), enck.PointerChars(), encv.Encoding(), encv.Pointer()));
+		} else {
+			::emscripten::val emvalRecord = ::emscripten::val::object();
+			::tc::for_each(::std::forward<Rng>(rngpairkv), [&](auto&& pairkv) noexcept {
+				emvalRecord.set(
+					::tc::explicit_cast<K>(::std::get<0>(::std::forward<decltype(pairkv)>(pairkv))),
+					::tc::explicit_cast<V>(::std::get<1>(::std::forward<decltype(pairkv)>(pairkv)))
+				);
+			});
+			return Record<K, V>(tc_move(emvalRecord));
+		}
+	}
+
+private:
+	template<typename T>
+	::std::vector<T> Read(bool bValues) noexcept {
+		if constexpr(::tc::jst::range_detail::IsArrayReadInChunks<T>::value) {
+			static auto const fnEncodeRecord = ::tc::jst::marshal_detail::LookupModuleFunction("tc_js_marshal_detail_js_EncodeRecord");
+			::tc::jst::marshal_detail::CArenaScope scope;
+			return ::tc::jst::range_detail::DecodeBuffer<T>(fnEncodeRecord(
+				_getEmval(), bValues, ::tc::jst::range_detail::IsArrayReadAsHandle<T>::value
+			).template as<::tc::jst::marshal_detail::PointerNumber>());
+		} else {
+			::emscripten::val const emvalKeys = ::emscripten::val::global("Object").call<::emscripten::val>("keys", _getEmval());
+			int const n = emvalKeys["length"].template as<int>();
+			::std::vector<T> vect;
+			vect.reserve(n);
+			for(int i = 0; i < n; ++i) {
+				vect.emplace_back((bValues ? _getEmval()[emvalKeys[i]] : emvalKeys[i]).template as<T>());
+			}
+			return vect;
+		}
+	}
+};
+
+// Also used for IterableIterator and generators: iterating them returns the object itself.
+template<typename T>
+struct _js_Iterable : virtual ::tc::jst::IObject {
+	static_assert(::tc::jst::IsJsInteropable<T>::value);
+
+	struct _tcjs_definitions {
+		using value_type = T;
+	};
+
+	// Single pass input range which reads nChunkSize elements per call into JS.
+	// Elements are requested from the JS iterator ahead of their use, at most nChunkSize - 1 of them are never used
+	// if the iteration stops early.
+	auto read_chunked(int nChunkSize = ::tc::jst::range_detail::c_nArrayChunkSize) noexcept {
+		static auto const fnGetIterator = ::tc::jst::marshal_detail::LookupModuleFunction("tc_js_marshal_detail_js_GetIterator");
+		return ::tc::jst::range_detail::js_iterable_range<T>(fnGetIterator(_getEmval()), nChunkSize);
+	}
+};
+
+// Also used for AsyncIterableIterator and async generators.
+template<typename T>
+struct _js_AsyncIterable : virtual ::tc::jst::IObject {
+	static_assert(::tc::jst::IsJsInteropable<T>::value);
+
+	struct _tcjs_definitions {
+		using value_type = T;
+	};
+
+	auto read_chunked(int nChunkSize = ::tc::jst::range_detail::c_nArrayChunkSize) noexcept {
+		static auto const fnGetAsyncIterator = ::tc::jst::marshal_detail::LookupModuleFunction("tc_js_marshal_detail_js_GetAsyncIterator");
+		return ::tc::jst::js_async_chunk_reader<T>(fnGetAsyncIterator(_getEmval()), nChunkSize);
+	}
+};
+
+// The snapshot functions copy all keys, values or entries into a std::vector with a single call into JS
+// instead of calling into JS for every step of a JS iterator.
+template<typename K, typename V>
+struct _js_Map : virtual ::tc::jst::IObject {
+	static_assert(::tc::jst::IsJsInteropable<K>::value);
+	static_assert(::tc::jst::IsJsInteropable<V>::value);
+
+	struct _tcjs_definitions {
+		using key_type = K;
+		using mapped_type = V;
+	};
+
+	auto size() noexcept { return ::tc::explicit_cast<int>(_getProperty<double>("size")); }
+	auto get(K const& k) noexcept { return _call<::tc::jst::js_optional<V>>("get", k); }
+	auto has(K const& k) noexcept { return _call<bool>("has", k); }
+	void set(K const& k, V const& v) noexcept { _call<void>("set", k, v); }
+	auto delete_(K const& k) noexcept { return _call<bool>("delete", k); }
+	void clear() noexcept { _call<void>("clear"); }
+
+	auto keys_snapshot() noexcept {
+		return ::tc::jst::range_detail::ReadIterator<K>(_getEmval().call<::emscripten::val>("keys"), size());
+	}
+
+	auto values_snapshot() noexcept {
+		return ::tc::jst::range_detail::ReadIterator<V>(_getEmval().call<::emscripten::val>("values"), size());
+	}
+
+	auto entries_snapshot() noexcept {
+		if constexpr(::tc::jst::range_detail::IsArrayReadInChunks<K>::value && ::tc::jst::range_detail::IsArrayReadInChunks<V>::value) {
+			return ::tc::jst::range_detail::ReadMapEntries<K, V>(_getEmval());
+		} else {
+			return EntriesSnapshotSeparately();
+		}
+	}
+
+	static Map<K, V> _tcjs_construct() noexcept {
+		return Map<K, V>(::emscripten::val::global("Map").new_());
+	}
+
+private:
+	// Keys and values are read separately, the iteration order of Map guarantees that they correspond.
+	auto EntriesSnapshotSeparately() noexcept {
+		auto veck = keys_snapshot();
+		auto vecv = values_snapshot();
+		_ASSERTEQUAL(tc::size(veck), tc::size(vecv));
+		::std::vector<::std::pair<K, V>> vecpairkv;
+		vecpairkv.reserve(tc::size(veck));
+		for(::std::size_t i = 0; i < tc::size(veck); ++i) {
+			vecpairkv.emplace_back(tc_move(veck[i]), tc_move(vecv[i]));
+		}
+		return vecpairkv;
+	}
+};
+
+template<typename T>
+struct _js_Set : virtual ::tc::jst::IObject {
+	static_assert(::tc::jst::IsJsInteropable<T>::value);
+
+	struct _tcjs_definitions {
+		using value_type = T;
+	};
+
+	auto size() noexcept { return ::tc::explicit_cast<int>(_getProperty<double>("size")); }
+	auto has(T const& t) noexcept { return _call<bool>("has", t); }
+	void add(T const& t) noexcept { _call<void>("add", t); }
+	auto delete_(T const& t) noexcept { return _call<bool>("delete", t); }
+	void clear() noexcept { _call<void>("clear"); }
+
+	auto values_snapshot() noexcept {
+		return ::tc::jst::range_detail::ReadIterator<T>(_getEmval().call<::emscripten::val>("values"), size());
+	}
+
+	static Set<T> _tcjs_construct() noexcept {
+		return Set<T>(::emscripten::val::global("Set").new_());
+	}
+};
+
+struct _js_ArrayBuffer : virtual ::tc::jst::IObject {
+	auto byteLength() noexcept { return ::tc::explicit_cast<int>(_getProperty<double>("byteLength")); }
+	auto slice(int iBegin, int iEnd) noexcept { return _call<ArrayBuffer>("slice", iBegin, iEnd); }
+
+	static ArrayBuffer _tcjs_construct(int cb) noexcept {
+		return ArrayBuffer(::emscripten::val::global("ArrayBuffer").new_(cb));
+	}
+};
+
+// Typed arrays own their memory in JS. copy_to/copy_from/construction from a span copy all elements with a single call into JS.
+// To let JS read or write C++ memory without copying, use tc::jst::js_heap_view instead.
+template<typename T>
+struct _js_TypedArray : virtual ::tc::jst::IObject {
+	static_assert(::tc::jst::typed_array_detail::IsTypedArrayElement<T>::value);
+
+	struct _tcjs_definitions {
+		using value_type = T;
+	};
+
+	auto length() noexcept { return ::tc::explicit_cast<int>(_getProperty<double>("length")); }
+	auto byteLength() noexcept { return ::tc::explicit_cast<int>(_getProperty<double>("byteLength")); }
+	auto byteOffset() noexcept { return ::tc::explicit_cast<int>(_getProperty<double>("byteOffset")); }
+	auto buffer() noexcept { return _getProperty<ArrayBuffer>("buffer"); }
+	auto operator[](int i) && noexcept { return ::tc::explicit_cast<T>(_getProperty<double>(i)); }
+	void _setIndex(int i, T value) noexcept { _setProperty(i, ::tc::explicit_cast<double>(value)); }
+
+	// Shares the buffer, like JS subarray.
+	auto subarray(int iBegin, int iEnd) noexcept { return _call<TypedArray<T>>("subarray", iBegin, iEnd); }
+
+	// Copies the first min(length(), span.size()) elements into span and returns their number.
+	int copy_to(::std::span<T> span) noexcept {
+		static auto const fnCopyTo = ::tc::jst::marshal_detail::LookupModuleFunction("tc_js_marshal_detail_js_CopyTypedArrayTo");
+		return fnCopyTo(_getEmval(), ::emscripten::typed_memory_view(span.size(), span.data())).template as<int>();
+	}
+
+	// Copies span into this array starting at element iOffset. The elements must fit.
+	void copy_from(::std::span<T const> span, int iOffset = 0) noexcept {
+		static auto const fnCopyFrom = ::tc::jst::marshal_detail::LookupModuleFunction("tc_js_marshal_detail_js_CopyTypedArrayFrom");
+		_ASSERT(0 <= iOffset && iOffset + ::tc::explicit_cast<int>(span.size()) <= length());
+		fnCopyFrom(_getEmval(), ::emscripten::typed_memory_view(span.size(), span.data()), iOffset);
+	}
+
+	static TypedArray<T> _tcjs_construct(int n) noexcept {
+		return TypedArray<T>(::emscripten::val::global(::tc::jst::typed_array_detail::STypedArrayName<T>::c_szArray).new_(n));
+	}
+
+	static TypedArray<T> _tcjs_construct(::std::span<T const> span) noexcept {
+		static auto const fnCopyNew = ::tc::jst::marshal_detail::LookupModuleFunction("tc_js_marshal_detail_js_CopyTypedArrayNew");
+		return TypedArray<T>(fnCopyNew(::emscripten::typed_memory_view(span.size(), span.data())));
+	}
+
+	static TypedArray<T> _tcjs_construct(ArrayBuffer buffer, int nByteOffset, int n) noexcept {
+		return TypedArray<T>(::emscripten::val::global(::tc::jst::typed_array_detail::STypedArrayName<T>::c_szArray).new_(buffer, nByteOffset, n));
+	}
+};
+
+// Unlike JS, the byte order must always be specified. wasm is little-endian.
+struct _js_DataView : virtual ::tc::jst::IObject {
+	auto byteLength() noexcept { return ::tc::explicit_cast<int>(_getProperty<double>("byteLength")); }
+	auto byteOffset() noexcept { return ::tc::explicit_cast<int>(_getProperty<double>("byteOffset")); }
+	auto buffer() noexcept { return _getProperty<ArrayBuffer>("buffer"); }
+
+	template<typename T>
+	T get(int nByteOffset, bool bLittleEndian) noexcept {
+		return ::tc::explicit_cast<T>(_call<double>(::tc::jst::typed_array_detail::STypedArrayName<T>::c_szGet, nByteOffset, bLittleEndian));
+	}
+
+	template<typename T>
+	void set(int nByteOffset, T value, bool bLittleEndian) noexcept {
+		_call<void>(::tc::jst::typed_array_detail::STypedArrayName<T>::c_szSet, nByteOffset, ::tc::explicit_cast<double>(value), bLittleEndian);
+	}
+
+	static DataView _tcjs_construct(ArrayBuffer buffer) noexcept {
+		return DataView(::emscripten::val::global("DataView").new_(buffer));
+	}
+
+	static DataView _tcjs_construct(ArrayBuffer buffer, int nByteOffset, int cb) noexcept {
+		return DataView(::emscripten::val::global("DataView").new_(buffer, nByteOffset, cb));
+	}
 };
 
 template<typename T> struct RemovePromise { using type = T; };
@@ -136,6 +971,21 @@ using no_adl::ReadonlyArray;
 using no_adl::Promise;
 using no_adl::Record;
 using no_adl::console;
+using no_adl::Iterable;
+using no_adl::AsyncIterable;
+using no_adl::Map;
+using no_adl::Set;
+using no_adl::ArrayBuffer;
+using no_adl::TypedArray;
+using no_adl::Int8Array;
+using no_adl::Uint8Array;
+using no_adl::Int16Array;
+using no_adl::Uint16Array;
+using no_adl::Int32Array;
+using no_adl::Uint32Array;
+using no_adl::Float32Array;
+using no_adl::Float64Array;
+using no_adl::DataView;
 
 inline auto stackTrace() noexcept {  // Expects non-standard `stackTrace()` function in JS to be available globally.
 	return ::emscripten::val::global("stackTrace")().template as<tc::jst::js_string>();
@@ -143,6 +993,189 @@ inline auto stackTrace() noexcept {  // Expects non-standard `stackTrace()` func
 
 } // namespace tc::js
 
+namespace tc::jst {
+namespace no_adl {
+// Reads an async iterator in chunks. Every chunk is requested explicitly by next_chunk, so a slow consumer
+// applies backpressure: the JS iterator is not advanced beyond the requested chunk.
+// The Promise resolves to fewer than nChunkSize elements only if the iterator is done.
+template<typename T>
+struct js_async_chunk_reader final {
+	js_async_chunk_reader(emscripten::val emvalIterator, int nChunkSize) noexcept
+		: m_emvalIterator(tc_move(emvalIterator))
+		, m_nChunkSize(nChunkSize)
+	{
+		_ASSERT(0 < nChunkSize);
+	}
+
+	// Must not be called again before the returned Promise is settled.
+	tc::js::Promise<tc::js::ReadonlyArray<T>> next_chunk() & noexcept {
+		static auto const fnReadAsyncIterator = marshal_detail::LookupModuleFunction("tc_js_marshal_detail_js_ReadAsyncIterator");
+		return tc::js::Promise<tc::js::ReadonlyArray<T>>(fnReadAsyncIterator(m_emvalIterator, m_nChunkSize));
+	}
+
+	int chunk_size() const& noexcept { return m_nChunkSize; }
+
+private:
+	emscripten::val m_emvalIterator;
+	int m_nChunkSize;
+};
+} // namespace no_adl
+
+// Packs a range of C++ structs listed by TC_JS_STRUCT into one object with an array per field, decoded with a single call into JS.
+// Numeric fields become Float64Arrays, which suits rendering code working on columns, other fields plain arrays.
+template<typename Rng>
+tc::js::Record<js_string, js_unknown> make_js_columns(Rng&& rng) noexcept {
+	return tc::js::Record<js_string, js_unknown>(
+		struct_detail::CPackedStructs<tc::remove_cvref_t<tc::range_reference_t<Rng>>>(std::forward<Rng>(rng)).Decode("columns")
+	);
+}
+
+namespace no_adl {
+// Parameter type of typed arrays in generated bindings. Also accepts contiguous C++ ranges, e.g. std::span<float const>.
+// Without bCopy, the JS function receives a view of wasm memory, which it must not keep after it returns.
+// With bCopy, used for functions returning a Promise, the JS function receives a copy which it owns.
+template<typename T, bool bCopy>
+struct js_typed_array_param final {
+	js_typed_array_param(tc::js::TypedArray<T> jtarr) noexcept : m_emval(tc_move(jtarr).getEmval()) {}
+
+	template<typename Rng, std::enable_if_t<std::is_convertible<Rng&&, std::span<T const>>::value>* = nullptr>
+	js_typed_array_param(Rng&& rng) noexcept : m_emval(FromSpan(std::forward<Rng>(rng))) {}
+
+	explicit js_typed_array_param(emscripten::val const& emval) noexcept : m_emval(emval) {}
+
+	emscripten::val const& getEmval() const& noexcept { return m_emval; }
+
+private:
+	emscripten::val m_emval;
+
+	static emscripten::val FromSpan(std::span<T const> span) noexcept {
+		if constexpr(bCopy) {
+			return tc::js::TypedArray<T>(create_js_object, span).getEmval();
+		} else {
+			return emscripten::val(emscripten::typed_memory_view(span.size(), span.data()));
+		}
+	}
+};
+
+template<typename T, bool bCopy>
+struct IsJsInteropable<js_typed_array_param<T, bCopy>> : std::true_type {};
+} // namespace no_adl
+using no_adl::js_typed_array_param;
+
+namespace emscripten_interop_detail::no_adl {
+template<typename T, bool bCopy>
+struct IsEmvalWrapper<js_typed_array_param<T, bCopy>> : std::true_type {};
+} // namespace emscripten_interop_detail::no_adl
+} // namespace tc::jst
+
+namespace tc::jst::property_detail {
+// Reads or writes a fixed list of properties of a JS object with a single call into JS. Used by the members which stage1
+// generates for struct snapshots (@tcjsSnapshot) and for constructing object-literal interfaces from a fields_type.
+// Numbers, booleans and integral enums are passed as doubles, other values as handles.
+// The JS functions are compiled once per list of properties, so accessors and factories should be static.
+template<typename T>
+inline constexpr range_detail::EArrayEncoding c_earrencProperty =
+	std::is_same<T, bool>::value ? range_detail::EArrayEncoding::boolean
+	: range_detail::IsArrayReadAsNumber<T>::value ? range_detail::EArrayEncoding::number
+	: range_detail::EArrayEncoding::handle;
+
+template<typename... Ts>
+emscripten::val CompilePropertyFunctions(char const* szModuleFunction, std::array<char const*, sizeof...(Ts)> const& aszName) noexcept {
+	emscripten::val emvalNames = emscripten::val::array();
+	tc::for_each(aszName, [&](char const* szName) noexcept {
+		emvalNames.call<void>("push", emscripten::val(szName));
+	});
+	std::array<int, sizeof...(Ts)> const aiEncoding{static_cast<int>(c_earrencProperty<Ts>)...};
+	return marshal_detail::LookupModuleFunction(szModuleFunction)(emvalNames, emscripten::typed_memory_view(tc::size(aiEncoding), aiEncoding.data()));
+}
+
+namespace no_adl {
+// Values of properties of types Ts, in the order in which they are put or taken. The number of values is known at compile time,
+// so the buffers live on the stack, which is part of wasm memory as well, and JS accesses them through the HEAP* views.
+template<typename... Ts>
+struct CPropertyBuffers final : private tc::noncopyable {
+	template<typename T>
+	void Put(T const& t) & noexcept {
+		if constexpr(range_detail::IsArrayReadAsNumber<T>::value) {
+			m_adbl[m_iNumber++] = range_detail::ToArrayNumber(t);
+		} else {
+			m_ah[m_iHandle++] = marshal_detail::ReleaseHandle(emscripten::val(t)); // JS takes ownership
+		}
+	}
+
+	template<typename T>
+	T Take() & noexcept {
+		if constexpr(range_detail::IsArrayReadAsNumber<T>::value) {
+			return range_detail::FromArrayNumber<T>(m_adbl[m_iNumber++]);
+		} else {
+			return marshal_detail::TakeHandle(m_ah[m_iHandle++]).template as<T>();
+		}
+	}
+
+	marshal_detail::PointerNumber NumberPointer() & noexcept { return reinterpret_cast<marshal_detail::PointerNumber>(m_adbl.data()); }
+	marshal_detail::PointerNumber HandlePointer() & noexcept { return reinterpret_cast<marshal_detail::PointerNumber>(m_ah.data()); }
+
+private:
+	static constexpr std::size_t c_nNumbers = (0 + ... + (range_detail::IsArrayReadAsNumber<Ts>::value ? 1 : 0));
+	static constexpr std::size_t c_nHandles = sizeof...(Ts) - c_nNumbers;
+
+	std::array<double, c_nNumbers> m_adbl;
+	std::array<std::uint32_t, c_nHandles> m_ah;
+	int m_iNumber = 0;
+	int m_iHandle = 0;
+};
+
+template<typename... Ts>
+struct CStructAccessor final : private tc::noncopyable {
+	explicit CStructAccessor(std::array<char const*, sizeof...(Ts)> const& aszName) noexcept
+		: m_emvalAccessor(CompilePropertyFunctions<Ts...>("tc_js_marshal_detail_js_CreateStructAccessor", aszName))
+	{}
+
+	template<typename Struct>
+	Struct Read(emscripten::val const& emval) const& noexcept {
+		CPropertyBuffers<Ts...> buffers;
+		m_emvalAccessor.call<void>("read", emval, buffers.NumberPointer(), buffers.HandlePointer());
+		// Elements of a braced initializer list are evaluated in order, so the properties are taken in declaration order.
+		return Struct{buffers.template Take<Ts>()...};
+	}
+
+	void Write(emscripten::val const& emval, Ts const&... ts) const& noexcept {
+		CPropertyBuffers<Ts...> buffers;
+		(buffers.Put(ts), ...);
+		m_emvalAccessor.call<void>("write", emval, buffers.NumberPointer(), buffers.HandlePointer());
+	}
+
+private:
+	emscripten::val m_emvalAccessor;
+};
+
+// Creates an object literal with the properties whose values are set, unset properties are not created at all.
+template<typename... Ts>
+struct CObjectFactory final : private tc::noncopyable {
+	explicit CObjectFactory(std::array<char const*, sizeof...(Ts)> const& aszName) noexcept
+		: m_emvalFactory(CompilePropertyFunctions<Ts...>("tc_js_marshal_detail_js_CreateObjectFactory", aszName))
+	{}
+
+	emscripten::val Create(std::optional<Ts> const&... ots) const& noexcept {
+		CPropertyBuffers<Ts...> buffers;
+		std::array<std::uint8_t, sizeof...(Ts)> abSet{static_cast<std::uint8_t>(ots ? 1 : 0)...};
+		([&]() noexcept {
+			if(ots) {
+				buffers.Put(*ots);
+			}
+		}(), ...);
+		return m_emvalFactory(reinterpret_cast<marshal_detail::PointerNumber>(abSet.data()), buffers.NumberPointer(), buffers.HandlePointer());
+	}
+
+private:
+	emscripten::val m_emvalFactory;
+};
+} // namespace no_adl
+using no_adl::CStructAccessor;
+using no_adl::CObjectFactory;
+} // namespace tc::jst::property_detail
+
+
 // Define iterator types for tc::js::Array and tc::js::ReadonlyArray
 #define JS_RANGE_WITH_ITERATORS(JsNamespace, JsType) \
 	namespace tc::jst::range_detail { \
@@ -151,10 +1184,19 @@ inline auto stackTrace() noexcept {  // Expects non-standard `stackTrace()` func
 			struct FGet ## JsType ## Index final { \
 			private: \
 				JsNamespace::JsType<T> m_t; \
+				/* Shared by copies of the iterator, created on first access so end iterators do not allocate. */ \
+				std::shared_ptr<CArrayChunkCache<T>> mutable m_pchunkcache; \
 			public: \
 				FGet ## JsType ## Index (JsNamespace::JsType<T> t) : m_t(tc_move(t)) {}; \
 				T operator()(int i) const& noexcept { \
-					return m_t[i]; \
+					if constexpr(IsArrayReadInChunks<T>::value) { \
+						if(!m_pchunkcache) { \
+							m_pchunkcache = std::make_shared<CArrayChunkCache<T>>(); \
+						} \
+						return m_pchunkcache->Get(m_t.getEmval(), i); \
+					} else { \
+						return m_t[i]; \
+					} \
 				} \
 			}; \
 		} \
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <emscripten/threading.h>
+#include <emscripten/val.h>
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include "noncopyable.h"
+#include "range_defines.h"
+#include "js_types.h"
+#include "js_marshal_detail.h"
+
+namespace tc::jst {
+namespace channel_detail {
+// Accessed by js_channel.js as uint32 by index, so the layout must not change.
+struct SHeader final {
+	std::atomic<std::uint32_t> m_nWrite; // Bytes written, wraps around at 2^32. Written by the producer only.
+	std::atomic<std::uint32_t> m_nRead; // Bytes read, wraps around at 2^32. Written by the consumer only.
+	std::atomic<std::uint32_t> m_bWaiting; // The consumer waits on m_nWrite, the producer must notify it.
+	std::atomic<std::uint32_t> m_bClosed;
+	std::uint32_t m_cbCapacity;
+	std::uint32_t m_pbyData;
+};
+static_assert(std::is_standard_layout<SHeader>::value);
+static_assert(sizeof(SHeader) == 6 * sizeof(std::uint32_t));
+static_assert(std::atomic<std::uint32_t>::is_always_lock_free);
+
+inline constexpr std::uint32_t c_nTypePadding = 0xFFFFFFFF;
+inline constexpr std::uint32_t c_cbFrameHeader = 2 * sizeof(std::uint32_t);
+inline constexpr std::uint32_t c_cbCapacityMin = 64;
+
+inline emscripten::val CreateProducer(SHeader* pheader) noexcept {
+	static auto const fnCreateProducer = marshal_detail::LookupModuleFunction("tc_js_channel_detail_js_CreateProducer", "js_channel.js");
+	return fnCreateProducer(reinterpret_cast<std::uintptr_t>(pheader));
+}
+} // namespace channel_detail
+
+namespace no_adl {
+// A message written by tryWrite(nType, data) of the JS producer. The payload is only valid within js_channel::consume.
+struct js_channel_message final {
+	std::uint32_t m_nType;
+	std::span<std::byte const> m_spanby;
+
+	// Payload written from a JS string.
+	std::string_view string_view() const& noexcept {
+		return std::string_view(reinterpret_cast<char const*>(m_spanby.data()), m_spanby.size());
+	}
+
+	// Payload written from a typed array, e.g. Float64Array for T = double. Payloads are aligned to 8 bytes.
+	template<typename T>
+	std::span<T const> span() const& noexcept {
+		static_assert(std::is_trivially_copyable<T>::value && alignof(T) <= 8);
+		_ASSERTEQUAL(m_spanby.size() % sizeof(T), 0);
+		return std::span<T const>(reinterpret_cast<T const*>(m_spanby.data()), m_spanby.size() / sizeof(T));
+	}
+};
+
+// Lock-free single-producer single-consumer ring buffer of messages from JS to C++ in wasm memory.
+// JS writes messages with tryWrite(nType, data) on the object returned by producer(), see js_channel.js, and a C++ thread
+// reads them with wait and consume. Neither side calls the other per message, the consumer is only woken via
+// Atomics.notify if it is blocked in wait. Requires building with -pthread. Without threads, the single thread may call
+// consume, but must not block in wait.
+// Messages larger than half of the capacity are rejected by the producer.
+struct js_channel final : private tc::nonmovable {
+	// cbCapacity is rounded up to a power of 2.
+	explicit js_channel(std::uint32_t cbCapacity) noexcept
+		: m_cbCapacity(std::bit_ceil(std::max(cbCapacity, channel_detail::c_cbCapacityMin)))
+		, m_pby(std::make_unique<std::byte[]>(m_cbCapacity))
+	{
+		_ASSERTEQUAL(reinterpret_cast<std::uintptr_t>(m_pby.get()) % 8, 0);
+		m_header.m_cbCapacity = m_cbCapacity;
+		m_header.m_pbyData = static_cast<std::uint32_t>(reinterpret_cast<std::uintptr_t>(m_pby.get()));
+	}
+
+	// JS object with tryWrite(nType, data), close() and maxMessageSize. Must be called on the thread of the JS producer,
+	// and the channel must outlive the producer.
+	js_unknown producer() & noexcept {
+		return js_unknown(channel_detail::CreateProducer(&m_header));
+	}
+
+	// Blocks until a message can be consumed or the producer has closed the channel.
+	// Returns false if the channel is closed and all messages have been consumed.
+	bool wait() & noexcept {
+		for(;;) {
+			std::uint32_t const nWrite = m_header.m_nWrite.load();
+			if(nWrite != m_header.m_nRead.load(std::memory_order_relaxed)) {
+				return true;
+			}
+			if(m_header.m_bClosed.load()) {
+				// Messages written before closing are visible, nWrite was stored before m_bClosed.
+				return m_header.m_nWrite.load() != m_header.m_nRead.load(std::memory_order_relaxed);
+			}
+			// Either the producer observes m_bWaiting and notifies, or we observe its new m_nWrite and do not block.
+			m_header.m_bWaiting.store(1);
+			if(nWrite == m_header.m_nWrite.load() && !m_header.m_bClosed.load()) {
+				emscripten_futex_wait(&m_header.m_nWrite, nWrite, INFINITY);
+			}
+			m_header.m_bWaiting.store(0);
+		}
+	}
+
+	// Calls func(js_channel_message const&) for each message written so far, without blocking.
+	// The space of a message is released to the producer as soon as func returns. Returns the number of messages consumed.
+	template<typename Func>
+	int consume(Func func) & noexcept {
+		int nMessages = 0;
+		std::uint32_t const nWrite = m_header.m_nWrite.load(std::memory_order_acquire);
+		std::uint32_t nRead = m_header.m_nRead.load(std::memory_order_relaxed);
+		while(nRead != nWrite) {
+			std::byte const* const pbyFrame = m_pby.get() + (nRead & (m_cbCapacity - 1));
+			std::uint32_t const cb = reinterpret_cast<std::uint32_t const*>(pbyFrame)[0];
+			std::uint32_t const nType = reinterpret_cast<std::uint32_t const*>(pbyFrame)[1];
+			if(channel_detail::c_nTypePadding == nType) {
+				nRead += channel_detail::c_cbFrameHeader + cb;
+			} else {
+				func(js_channel_message{nType, std::span<std::byte const>(pbyFrame + channel_detail::c_cbFrameHeader, cb)});
+				++nMessages;
+				nRead += channel_detail::c_cbFrameHeader + ((cb + 8) & ~std::uint32_t(7));
+			}
+			m_header.m_nRead.store(nRead, std::memory_order_release);
+		}
+		return nMessages;
+	}
+
+	bool closed() const& noexcept {
+		return m_header.m_bClosed.load();
+	}
+
+private:
+	channel_detail::SHeader m_header{0, 0, 0, 0, 0, 0};
+	std::uint32_t m_cbCapacity;
+	std::unique_ptr<std::byte[]> m_pby;
+};
+} // namespace no_adl
+using no_adl::js_channel;
+using no_adl::js_channel_message;
+} // namespace tc::jst
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <emscripten/val.h>
+#include <coroutine>
+#include <optional>
+#include "noncopyable.h"
+#include "range_defines.h"
+#include "tc_move.h"
+#include "js_types.h"
+#include "js_callback.h"
+#include "js_bootstrap.h"
+
+// Awaitables for C++20 coroutines. Separate from js_bootstrap.h because it requires a toolchain with <coroutine>.
+// The coroutine is resumed from the JS callbacks of the awaited Promise, i.e., from the JS event loop.
+namespace tc::jst {
+namespace no_adl {
+// Awaits the next chunk of a js_async_chunk_reader. Each co_await requests exactly one chunk, so a coroutine consuming
+// the chunks applies the same backpressure as next_chunk. Yields std::nullopt if the JS iterator has thrown.
+// Lives in the coroutine frame while the coroutine is suspended, so the callbacks passed to JS stay valid until resumed.
+template<typename T>
+struct js_chunk_awaiter final : private tc::nonmovable {
+	explicit js_chunk_awaiter(js_async_chunk_reader<T>& reader) noexcept : m_reader(reader) {}
+
+	bool await_ready() const& noexcept { return false; }
+
+	void await_suspend(std::coroutine_handle<> h) & noexcept {
+		m_h = h;
+		m_reader.next_chunk()->then(m_jsfnOnChunk, m_jsfnOnError);
+	}
+
+	std::optional<tc::js::ReadonlyArray<T>> await_resume() & noexcept {
+		return tc_move(m_ojarrChunk);
+	}
+
+private:
+	js_async_chunk_reader<T>& m_reader;
+	std::coroutine_handle<> m_h;
+	std::optional<tc::js::ReadonlyArray<T>> m_ojarrChunk;
+
+	// Resuming may destroy the coroutine frame and this awaiter with it, so nothing may be accessed afterwards.
+	TC_JS_MEMBER_FUNCTION(js_chunk_awaiter, m_jsfnOnChunk, void, (tc::js::ReadonlyArray<T> jarr)) {
+		m_ojarrChunk.emplace(tc_move(jarr));
+		m_h.resume();
+	}
+
+	TC_JS_MEMBER_FUNCTION(js_chunk_awaiter, m_jsfnOnError, void, (js_unknown)) {
+		m_h.resume();
+	}
+};
+} // namespace no_adl
+using no_adl::js_chunk_awaiter;
+
+// co_await next_chunk_awaitable(reader) instead of reader.next_chunk()->then(...).
+template<typename T>
+js_chunk_awaiter<T> next_chunk_awaitable(js_async_chunk_reader<T>& reader) noexcept {
+	return js_chunk_awaiter<T>(reader);
+}
+} // namespace tc::jst
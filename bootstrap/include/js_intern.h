@@ -0,0 +1,178 @@
+#pragma once
+
+#include <emscripten/val.h>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "explicit_cast.h"
+#include "noncopyable.h"
+#include "range_defines.h"
+#include "range.h"
+#include "tc_move.h"
+#include "type_traits.h"
+#include "js_types.h"
+#include "js_bootstrap.h"
+#include "js_marshal_detail.h"
+
+namespace tc::jst {
+// Dense IDs of JS strings. IDs are assigned in order of first interning, starting at 0,
+// and are only meaningful together with the js_string_interner which produced them.
+enum class js_string_id : int {};
+
+namespace intern_detail {
+inline emscripten::val CreateInterner() noexcept {
+	static auto const creator = marshal_detail::LookupModuleFunction("tc_js_intern_detail_js_CreateInterner", "js_intern.js");
+	return creator();
+}
+} // namespace intern_detail
+
+namespace no_adl {
+// Maps each distinct JS string to a js_string_id with a single call into JS. The strings themselves never
+// leave JS, so interning does not pay for UTF-8 conversion and allocation of a std::string.
+struct js_string_interner final : private tc::noncopyable {
+	js_string_interner() noexcept : m_emval(intern_detail::CreateInterner()) {}
+	js_string_interner(js_string_interner&&) noexcept = default;
+	js_string_interner& operator=(js_string_interner&&) noexcept = default;
+
+	js_string_id intern(js_string const& str) & noexcept {
+		return static_cast<js_string_id>(m_emval.call<int>("intern", str));
+	}
+
+	// Interns all elements of the array with a single call into JS (plus one to query the length).
+	std::vector<js_string_id> intern(tc::js::Array<js_string> const& jarrstr) & noexcept {
+		marshal_detail::CArenaScope scope;
+		auto const spann = marshal_detail::ArenaSpan<int>(jarrstr->length());
+		if(!tc::empty(spann)) {
+			m_emval.call<void>("internArray", jarrstr, reinterpret_cast<marshal_detail::PointerNumber>(spann.data()), tc::size(spann));
+		}
+		return tc::make_vector(tc::transform(spann, [](int n) noexcept { return static_cast<js_string_id>(n); }));
+	}
+
+	// Returns the ID if the string has been interned before, does not intern it otherwise.
+	std::optional<js_string_id> find(js_string const& str) const& noexcept {
+		auto const n = m_emval.call<int>("find", str);
+		if(n < 0) {
+			return std::nullopt;
+		}
+		return static_cast<js_string_id>(n);
+	}
+
+	js_string lookup(js_string_id id) const& noexcept {
+		_ASSERT(0 <= static_cast<int>(id) && static_cast<int>(id) < size());
+		return m_emval.call<js_string>("lookup", static_cast<int>(id));
+	}
+
+	// Reverse lookup of a range of IDs with a single call into JS.
+	template<typename Rng, std::enable_if_t<std::is_same<tc::remove_cvref_t<tc::range_reference_t<Rng>>, js_string_id>::value>* = nullptr>
+	tc::js::Array<js_string> lookup(Rng const& rngid) const& noexcept {
+		marshal_detail::CArenaScope scope;
+		marshal_detail::CArenaVector<int> vecn;
+		tc::for_each(rngid, [&](js_string_id id) noexcept {
+			vecn.push_back(static_cast<int>(id));
+		});
+		return tc::js::Array<js_string>(m_emval.call<emscripten::val>("lookupArray", vecn.Pointer(), vecn.size()));
+	}
+
+	int size() const& noexcept {
+		return m_emval.call<int>("size");
+	}
+
+private:
+	emscripten::val m_emval;
+};
+} // namespace no_adl
+using no_adl::js_string_interner;
+
+// Identity of a JS object or function. IDs are assigned on first request, are never reused and are the same for all callers,
+// so two wrappers have equal IDs iff their objects are strictlyEquals. Unlike strictlyEquals, IDs can be compared and hashed
+// without calling into JS. Requesting an ID does not keep the object alive.
+// Only js_ref has IDs: primitives such as strings cannot be WeakMap keys, comparing them by value needs no ID anyway.
+enum class js_identity_id : std::uint64_t {};
+
+template<typename T, std::enable_if_t<tc::is_instance_or_derived<js_ref, T>::value>* = nullptr>
+js_identity_id identity_id(T const& jobj) noexcept {
+	static auto const fnIdentityId = marshal_detail::LookupModuleFunction("tc_js_intern_detail_js_IdentityId", "js_intern.js");
+	return static_cast<js_identity_id>(fnIdentityId(jobj).template as<double>());
+}
+
+// IDs of all elements with a single call into JS (plus one to query the length).
+template<typename T>
+std::vector<js_identity_id> identity_ids(tc::js::Array<T> const& jarr) noexcept {
+	static_assert(tc::is_instance_or_derived<js_ref, T>::value);
+	static auto const fnIdentityIds = marshal_detail::LookupModuleFunction("tc_js_intern_detail_js_IdentityIds", "js_intern.js");
+	marshal_detail::CArenaScope scope;
+	auto const spandbl = marshal_detail::ArenaSpan<double>(jarr->length());
+	if(!tc::empty(spandbl)) {
+		fnIdentityIds(jarr, reinterpret_cast<marshal_detail::PointerNumber>(spandbl.data()), tc::size(spandbl));
+	}
+	return tc::make_vector(tc::transform(spandbl, [](double dbl) noexcept { return static_cast<js_identity_id>(dbl); }));
+}
+
+namespace no_adl {
+// Hash map keyed by the identity of JS objects, like a JS Map with object keys. Every operation calls into JS once
+// to get the identity_id of the key, comparing and hashing keys happens in C++. Keys are kept alive by the map.
+template<typename K, typename V>
+struct js_identity_map final {
+	static_assert(tc::is_instance_or_derived<js_ref, K>::value);
+
+	// Returns nullptr if there is no entry for k.
+	V* find(K const& k) & noexcept {
+		return find(identity_id(k));
+	}
+	V const* find(K const& k) const& noexcept {
+		return find(identity_id(k));
+	}
+	V* find(js_identity_id id) & noexcept {
+		auto const it = m_map.find(id);
+		return m_map.end() == it ? nullptr : std::addressof(it->second.second);
+	}
+	V const* find(js_identity_id id) const& noexcept {
+		auto const it = m_map.find(id);
+		return m_map.end() == it ? nullptr : std::addressof(it->second.second);
+	}
+
+	// Like std::unordered_map::try_emplace, returns the value for k and whether it has been inserted.
+	template<typename... Args>
+	std::pair<V&, bool> try_emplace(K const& k, Args&&... args) & noexcept {
+		return try_emplace_with_id(identity_id(k), k, std::forward<Args>(args)...);
+	}
+
+	// Like try_emplace, for callers which already know the identity_id of k, e.g. from a failed find.
+	template<typename... Args>
+	std::pair<V&, bool> try_emplace_with_id(js_identity_id id, K const& k, Args&&... args) & noexcept {
+		auto const [it, bInserted] = m_map.try_emplace(id, std::piecewise_construct, std::forward_as_tuple(k), std::forward_as_tuple(std::forward<Args>(args)...));
+		return {it->second.second, bInserted};
+	}
+
+	V& operator[](K const& k) & noexcept {
+		return try_emplace(k).first;
+	}
+
+	bool erase(K const& k) & noexcept {
+		return 0 != m_map.erase(identity_id(k));
+	}
+
+	// Calls func(K const&, V&) for each entry, in unspecified order.
+	template<typename Func>
+	void for_each(Func func) & noexcept {
+		for(auto& pairidkv : m_map) {
+			func(std::as_const(pairidkv.second.first), pairidkv.second.second);
+		}
+	}
+
+	std::size_t size() const& noexcept { return m_map.size(); }
+	bool empty() const& noexcept { return m_map.empty(); }
+	void clear() & noexcept { m_map.clear(); }
+
+private:
+	std::unordered_map<js_identity_id, std::pair<K, V>> m_map;
+};
+} // namespace no_adl
+using no_adl::js_identity_map;
+} // namespace tc::jst
@@ -0,0 +1,496 @@
+#pragma once
+
+#include <emscripten/val.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+#include "explicit_cast.h"
+#include "noncopyable.h"
+#include "range_defines.h"
+#include "range.h"
+#include "tc_move.h"
+#include "js_types.h"
+#include "js_marshal.h"
+
+namespace tc::jst {
+namespace no_adl {
+// UTF-8 JSON text in wasm memory, produced by JSON.stringify on the JS side.
+struct js_json_buffer final : private tc::noncopyable {
+	js_json_buffer(js_json_buffer&&) noexcept = default;
+	js_json_buffer& operator=(js_json_buffer&&) noexcept = default;
+
+	std::string_view str() const& noexcept {
+		return std::string_view(Begin(), *m_pn);
+	}
+
+private:
+	// Layout is defined by tc_js_marshal_detail_js_ToJsonBuffer: uint32 byte length, UTF-8 characters, terminating zero.
+	explicit js_json_buffer(marshal_detail::PointerNumber p) noexcept
+		: m_pn(marshal_detail::TakeOwnership<std::uint32_t>(p))
+	{}
+
+	char* Begin() const& noexcept { return reinterpret_cast<char*>(m_pn.get() + 1); }
+
+	marshal_detail::unique_malloc_ptr<std::uint32_t> m_pn;
+
+	friend std::optional<js_json_buffer> to_json_buffer(js_unknown const& junk) noexcept;
+	friend struct json_document;
+};
+
+// Serializes the value with JSON.stringify directly into wasm memory, so reading a large object graph
+// costs a single call into JS instead of one per property. Returns std::nullopt if JSON.stringify
+// returns undefined, e.g. for undefined or functions.
+inline std::optional<js_json_buffer> to_json_buffer(js_unknown const& junk) noexcept {
+	static auto const fnToJsonBuffer = marshal_detail::LookupModuleFunction("tc_js_marshal_detail_js_ToJsonBuffer");
+	auto const p = fnToJsonBuffer(junk).template as<marshal_detail::PointerNumber>();
+	if(0 == p) {
+		return std::nullopt;
+	}
+	return js_json_buffer(p);
+}
+} // namespace no_adl
+using no_adl::js_json_buffer;
+using no_adl::to_json_buffer;
+
+// Parses the UTF-8 JSON text with JSON.parse on the JS side.
+inline js_unknown from_json_buffer(std::string_view svJson) noexcept {
+	static auto const fnFromJsonBuffer = marshal_detail::LookupModuleFunction("tc_js_marshal_detail_js_FromJsonBuffer");
+	return js_unknown(fnFromJsonBuffer(reinterpret_cast<marshal_detail::PointerNumber>(svJson.data()), tc::size(svJson)));
+}
+
+// ---------------------------------------- C++ JSON parser ----------------------------------------
+// Parses JSON text in place: escaped strings are unescaped inside the text itself, so all strings
+// reported to the handler are std::string_views into the parsed text.
+// Accepts exactly the grammar of RFC 8259, e.g. no leading zeros and no unescaped control characters in strings.
+// Objects and arrays may be nested at most c_nJsonDepthMax levels deep, so untrusted text cannot overflow the stack.
+//
+// Handler has to provide:
+//	void null(); void boolean(bool); void number(double); void string(std::string_view);
+//	void key(std::string_view); void begin_object(); void end_object(); void begin_array(); void end_array();
+namespace json_detail {
+inline constexpr int c_nJsonDepthMax = 512;
+
+namespace no_adl {
+template<typename Handler>
+struct CParser final {
+	CParser(char* pchBegin, char* pchEnd, Handler& handler) noexcept
+		: m_pch(pchBegin)
+		, m_pchEnd(pchEnd)
+		, m_handler(handler)
+	{}
+
+	bool ParseDocument() & noexcept {
+		if(!ParseValue()) {
+			return false;
+		}
+		SkipWhitespace();
+		return m_pch == m_pchEnd;
+	}
+
+private:
+	char* m_pch;
+	char* const m_pchEnd;
+	Handler& m_handler;
+	int m_nDepth = 0;
+
+	void SkipWhitespace() & noexcept {
+		while(m_pch != m_pchEnd && (' ' == *m_pch || '\t' == *m_pch || '\n' == *m_pch || '\r' == *m_pch)) {
+			++m_pch;
+		}
+	}
+
+	bool Expect(char ch) & noexcept {
+		SkipWhitespace();
+		if(m_pch == m_pchEnd || ch != *m_pch) {
+			return false;
+		}
+		++m_pch;
+		return true;
+	}
+
+	bool ParseLiteral(std::string_view sv) & noexcept {
+		if(m_pchEnd - m_pch < tc::explicit_cast<std::ptrdiff_t>(tc::size(sv)) || sv != std::string_view(m_pch, tc::size(sv))) {
+			return false;
+		}
+		m_pch += tc::size(sv);
+		return true;
+	}
+
+	bool ParseValue() & noexcept {
+		SkipWhitespace();
+		if(m_pch == m_pchEnd) {
+			return false;
+		}
+		switch(*m_pch) {
+		case '{':
+		case '[': {
+			if(c_nJsonDepthMax == m_nDepth) {
+				return false;
+			}
+			++m_nDepth;
+			bool const bOk = '{' == *m_pch ? ParseObject() : ParseArray();
+			--m_nDepth;
+			return bOk;
+		}
+		case '"': {
+			std::string_view sv;
+			if(!ParseString(sv)) {
+				return false;
+			}
+			m_handler.string(sv);
+			return true;
+		}
+		case 't':
+			if(!ParseLiteral("true")) {
+				return false;
+			}
+			m_handler.boolean(true);
+			return true;
+		case 'f':
+			if(!ParseLiteral("false")) {
+				return false;
+			}
+			m_handler.boolean(false);
+			return true;
+		case 'n':
+			if(!ParseLiteral("null")) {
+				return false;
+			}
+			m_handler.null();
+			return true;
+		default:
+			return ParseNumber();
+		}
+	}
+
+	bool ParseObject() & noexcept {
+		++m_pch;
+		m_handler.begin_object();
+		SkipWhitespace();
+		if(m_pch != m_pchEnd && '}' == *m_pch) {
+			++m_pch;
+			m_handler.end_object();
+			return true;
+		}
+		for(;;) {
+			SkipWhitespace();
+			if(m_pch == m_pchEnd || '"' != *m_pch) {
+				return false;
+			}
+			std::string_view svKey;
+			if(!ParseString(svKey)) {
+				return false;
+			}
+			m_handler.key(svKey);
+			if(!Expect(':') || !ParseValue()) {
+				return false;
+			}
+			SkipWhitespace();
+			if(m_pch == m_pchEnd) {
+				return false;
+			}
+			if('}' == *m_pch) {
+				++m_pch;
+				m_handler.end_object();
+				return true;
+			}
+			if(',' != *m_pch) {
+				return false;
+			}
+			++m_pch;
+		}
+	}
+
+	bool ParseArray() & noexcept {
+		++m_pch;
+		m_handler.begin_array();
+		SkipWhitespace();
+		if(m_pch != m_pchEnd && ']' == *m_pch) {
+			++m_pch;
+			m_handler.end_array();
+			return true;
+		}
+		for(;;) {
+			if(!ParseValue()) {
+				return false;
+			}
+			SkipWhitespace();
+			if(m_pch == m_pchEnd) {
+				return false;
+			}
+			if(']' == *m_pch) {
+				++m_pch;
+				m_handler.end_array();
+				return true;
+			}
+			if(',' != *m_pch) {
+				return false;
+			}
+			++m_pch;
+		}
+	}
+
+	bool ParseHex4(unsigned& n) & noexcept {
+		if(m_pchEnd - m_pch < 4) {
+			return false;
+		}
+		n = 0;
+		for(int i = 0; i < 4; ++i) {
+			char const ch = *m_pch++;
+			n <<= 4;
+			if('0' <= ch && ch <= '9') {
+				n |= ch - '0';
+			} else if('a' <= ch && ch <= 'f') {
+				n |= ch - 'a' + 10;
+			} else if('A' <= ch && ch <= 'F') {
+				n |= ch - 'A' + 10;
+			} else {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	static char* EncodeUtf8(char* pchOut, unsigned nCodePoint) noexcept {
+		if(nCodePoint < 0x80) {
+			*pchOut++ = static_cast<char>(nCodePoint);
+		} else if(nCodePoint < 0x800) {
+			*pchOut++ = static_cast<char>(0xC0 | (nCodePoint >> 6));
+			*pchOut++ = static_cast<char>(0x80 | (nCodePoint & 0x3F));
+		} else if(nCodePoint < 0x10000) {
+			*pchOut++ = static_cast<char>(0xE0 | (nCodePoint >> 12));
+			*pchOut++ = static_cast<char>(0x80 | ((nCodePoint >> 6) & 0x3F));
+			*pchOut++ = static_cast<char>(0x80 | (nCodePoint & 0x3F));
+		} else {
+			*pchOut++ = static_cast<char>(0xF0 | (nCodePoint >> 18));
+			*pchOut++ = static_cast<char>(0x80 | ((nCodePoint >> 12) & 0x3F));
+			*pchOut++ = static_cast<char>(0x80 | ((nCodePoint >> 6) & 0x3F));
+			*pchOut++ = static_cast<char>(0x80 | (nCodePoint & 0x3F));
+		}
+		return pchOut;
+	}
+
+	static bool IsSurrogate(unsigned n) noexcept { return 0xD800 <= n && n < 0xE000; }
+	static bool IsHighSurrogate(unsigned n) noexcept { return 0xD800 <= n && n < 0xDC00; }
+	static bool IsLowSurrogate(unsigned n) noexcept { return 0xDC00 <= n && n < 0xE000; }
+
+	// The unescaped string is never longer than the escaped one, so it is written over the escaped string.
+	// Unpaired surrogates are replaced by U+FFFD.
+	bool ParseString(std::string_view& sv) & noexcept {
+		++m_pch;
+		char* const pchBegin = m_pch;
+		char* pchOut = m_pch;
+		for(;;) {
+			if(m_pch == m_pchEnd) {
+				return false;
+			}
+			char const ch = *m_pch++;
+			if('"' == ch) {
+				sv = std::string_view(pchBegin, pchOut - pchBegin);
+				return true;
+			} else if(static_cast<unsigned char>(ch) < 0x20) {
+				return false; // Control characters must be escaped.
+			} else if('\\' != ch) {
+				*pchOut++ = ch;
+			} else {
+				if(m_pch == m_pchEnd) {
+					return false;
+				}
+				switch(*m_pch++) {
+				case '"': *pchOut++ = '"'; break;
+				case '\\': *pchOut++ = '\\'; break;
+				case '/': *pchOut++ = '/'; break;
+				case 'b': *pchOut++ = '\b'; break;
+				case 'f': *pchOut++ = '\f'; break;
+				case 'n': *pchOut++ = '\n'; break;
+				case 'r': *pchOut++ = '\r'; break;
+				case 't': *pchOut++ = '\t'; break;
+				case 'u': {
+					unsigned nCodePoint;
+					if(!ParseHex4(nCodePoint)) {
+						return false;
+					}
+					if(IsHighSurrogate(nCodePoint) && 2 <= m_pchEnd - m_pch && '\\' == m_pch[0] && 'u' == m_pch[1]) {
+						m_pch += 2;
+						unsigned nLow;
+						if(!ParseHex4(nLow)) {
+							return false;
+						}
+						if(IsLowSurrogate(nLow)) {
+							nCodePoint = 0x10000 + ((nCodePoint - 0xD800) << 10) + (nLow - 0xDC00);
+						} else {
+							pchOut = EncodeUtf8(pchOut, 0xFFFD);
+							nCodePoint = nLow;
+						}
+					}
+					pchOut = EncodeUtf8(pchOut, IsSurrogate(nCodePoint) ? 0xFFFD : nCodePoint);
+					break;
+				}
+				default:
+					return false;
+				}
+			}
+		}
+	}
+
+	bool ParseNumber() & noexcept {
+		char* const pchBegin = m_pch;
+		auto SkipDigits = [&]() noexcept {
+			char* const pchDigits = m_pch;
+			while(m_pch != m_pchEnd && '0' <= *m_pch && *m_pch <= '9') {
+				++m_pch;
+			}
+			return pchDigits != m_pch;
+		};
+		if(m_pch != m_pchEnd && '-' == *m_pch) {
+			++m_pch;
+		}
+		// The integer part is 0 or does not start with 0. Digits after a leading 0 end the number and fail the enclosing value.
+		if(m_pch != m_pchEnd && '0' == *m_pch) {
+			++m_pch;
+		} else if(!SkipDigits()) {
+			return false;
+		}
+		if(m_pch != m_pchEnd && '.' == *m_pch) {
+			++m_pch;
+			if(!SkipDigits()) {
+				return false;
+			}
+		}
+		if(m_pch != m_pchEnd && ('e' == *m_pch || 'E' == *m_pch)) {
+			++m_pch;
+			if(m_pch != m_pchEnd && ('+' == *m_pch || '-' == *m_pch)) {
+				++m_pch;
+			}
+			if(!SkipDigits()) {
+				return false;
+			}
+		}
+		// std::strtod needs a terminated string and the number may end the text. Numbers beyond the range of double
+		// become infinity or zero, like with JSON.parse. musl, the C library of emscripten, always parses '.' as the
+		// decimal point, so the result does not depend on the locale set by setlocale.
+		// std::from_chars for double would need neither, but requires a newer libc++ than the documented minimum emscripten.
+		std::size_t const cch = m_pch - pchBegin;
+		char achNumber[64];
+		if(cch < tc::size(achNumber)) {
+			std::copy(pchBegin, m_pch, achNumber);
+			achNumber[cch] = '\0';
+			m_handler.number(std::strtod(achNumber, nullptr));
+		} else {
+			m_handler.number(std::strtod(std::string(pchBegin, m_pch).c_str(), nullptr));
+		}
+		return true;
+	}
+};
+} // namespace no_adl
+using no_adl::CParser;
+} // namespace json_detail
+
+// Returns false if the text is not valid JSON. The handler may have been called for a prefix of the text in that case.
+template<typename Handler>
+bool parse_json_in_place(char* pchBegin, char* pchEnd, Handler& handler) noexcept {
+	json_detail::CParser<Handler> parser(pchBegin, pchEnd, handler);
+	return parser.ParseDocument();
+}
+
+// ---------------------------------------- DOM ----------------------------------------
+namespace no_adl {
+struct json_value;
+using json_array = std::vector<json_value>;
+using json_object = std::vector<std::pair<std::string_view, json_value>>; // in document order
+
+struct json_value final {
+	std::variant<std::nullptr_t, bool, double, std::string_view, json_array, json_object> m_var;
+
+	bool is_null() const& noexcept { return std::holds_alternative<std::nullptr_t>(m_var); }
+
+	template<typename T>
+	T const* get_if() const& noexcept { return std::get_if<T>(&m_var); }
+
+	// Member lookup by linear search, returns nullptr if this is not an object or there is no such member.
+	json_value const* find(std::string_view svKey) const& noexcept {
+		if(auto const pobj = get_if<json_object>()) {
+			for(auto const& kv : *pobj) {
+				if(kv.first == svKey) {
+					return std::addressof(kv.second);
+				}
+			}
+		}
+		return nullptr;
+	}
+};
+
+// Owns the JSON text and the DOM built on top of it. All strings in the DOM point into the text.
+struct json_document final : private tc::noncopyable {
+	json_document(json_document&&) noexcept = default;
+	json_document& operator=(json_document&&) noexcept = default;
+
+	json_value const& root() const& noexcept { return m_jvRoot; }
+
+private:
+	json_document(js_json_buffer&& jsonbuf) noexcept : m_jsonbuf(tc_move(jsonbuf)) {}
+
+	js_json_buffer m_jsonbuf;
+	json_value m_jvRoot;
+
+	bool Parse() & noexcept;
+
+	struct FBuildDom final {
+		json_value& m_jvRoot;
+		std::vector<json_value*> m_vecpjvOpen; // containers which are being filled
+		std::string_view m_svKey;
+
+		json_value& Emplace(json_value jv) & noexcept {
+			if(tc::empty(m_vecpjvOpen)) {
+				m_jvRoot = tc_move(jv);
+				return m_jvRoot;
+			} else if(auto const parr = std::get_if<json_array>(&tc_back(m_vecpjvOpen)->m_var)) {
+				return parr->emplace_back(tc_move(jv));
+			} else {
+				return std::get<json_object>(tc_back(m_vecpjvOpen)->m_var).emplace_back(m_svKey, tc_move(jv)).second;
+			}
+		}
+
+		// Pointers to open containers stay valid: their parent container does not grow until they are closed.
+		void null() & noexcept { Emplace(json_value{nullptr}); }
+		void boolean(bool b) & noexcept { Emplace(json_value{b}); }
+		void number(double f) & noexcept { Emplace(json_value{f}); }
+		void string(std::string_view sv) & noexcept { Emplace(json_value{sv}); }
+		void key(std::string_view sv) & noexcept { m_svKey = sv; }
+		void begin_object() & noexcept { tc::cont_emplace_back(m_vecpjvOpen, std::addressof(Emplace(json_value{json_object()}))); }
+		void end_object() & noexcept { m_vecpjvOpen.pop_back(); }
+		void begin_array() & noexcept { tc::cont_emplace_back(m_vecpjvOpen, std::addressof(Emplace(json_value{json_array()}))); }
+		void end_array() & noexcept { m_vecpjvOpen.pop_back(); }
+	};
+
+	friend std::optional<json_document> parse_json(js_json_buffer&& jsonbuf) noexcept;
+};
+
+inline bool json_document::Parse() & noexcept {
+	FBuildDom builddom{m_jvRoot, {}, {}};
+	char* const pchBegin = m_jsonbuf.Begin();
+	return parse_json_in_place(pchBegin, pchBegin + tc::size(m_jsonbuf.str()), builddom);
+}
+
+// Builds a DOM over the JSON text, e.g., parse_json(*to_json_buffer(junk)).
+// The text is unescaped in place, so the buffer is consumed.
+inline std::optional<json_document> parse_json(js_json_buffer&& jsonbuf) noexcept {
+	json_document doc(tc_move(jsonbuf));
+	if(!doc.Parse()) {
+		return std::nullopt;
+	}
+	return std::optional<json_document>(tc_move(doc));
+}
+} // namespace no_adl
+using no_adl::json_value;
+using no_adl::json_array;
+using no_adl::json_object;
+using no_adl::json_document;
+using no_adl::parse_json;
+} // namespace tc::jst
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <emscripten/val.h>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include "explicit_cast.h"
+#include "noncopyable.h"
+#include "range_defines.h"
+#include "range.h"
+#include "js_types.h"
+#include "js_callback.h"
+#include "js_marshal.h"
+
+namespace tc::jst {
+// Order has to match tc_js_log_detail_js_Flush in js_log.js.
+enum class EConsoleLevel : std::uint8_t {
+	log,
+	error,
+	warn,
+	debug
+};
+
+namespace no_adl {
+// Collects formatted lines in wasm memory and writes them to the JS console with a single call into JS.
+// Lines are flushed when the buffer exceeds its size limit, on the next microtask boundary after the
+// first buffered line, or explicitly by flush(). Line order and console level are preserved.
+//
+// Unlike tc::js::console, arguments are formatted in C++ like tc::append arguments, not passed to JS as values.
+struct js_buffered_console final : private tc::nonmovable {
+	explicit js_buffered_console(std::size_t cchFlushThreshold = 64 * 1024) noexcept
+		: m_cchFlushThreshold(cchFlushThreshold)
+	{}
+
+	~js_buffered_console() {
+		flush();
+	}
+
+	template<typename... Rng>
+	void log(Rng&&... rng) & noexcept { Append(EConsoleLevel::log, std::forward<Rng>(rng)...); }
+
+	template<typename... Rng>
+	void error(Rng&&... rng) & noexcept { Append(EConsoleLevel::error, std::forward<Rng>(rng)...); }
+
+	template<typename... Rng>
+	void warn(Rng&&... rng) & noexcept { Append(EConsoleLevel::warn, std::forward<Rng>(rng)...); }
+
+	template<typename... Rng>
+	void debug(Rng&&... rng) & noexcept { Append(EConsoleLevel::debug, std::forward<Rng>(rng)...); }
+
+	void flush() & noexcept {
+		if(tc::empty(m_vecelevel)) {
+			return;
+		}
+		static auto const fnFlush = marshal_detail::LookupModuleFunction("tc_js_log_detail_js_Flush", "js_log.js");
+		tc::cont_emplace_back(m_vecnOffset, tc::explicit_cast<std::uint32_t>(tc::size(m_str)));
+		fnFlush(
+			emscripten::typed_memory_view(tc::size(m_vecelevel), reinterpret_cast<std::uint8_t const*>(tc::ptr_begin(m_vecelevel))),
+			emscripten::typed_memory_view(tc::size(m_vecnOffset), tc::ptr_begin(m_vecnOffset)),
+			emscripten::typed_memory_view(tc::size(m_str), reinterpret_cast<unsigned char const*>(m_str.data()))
+		);
+		// Keep the capacity, the buffers are reused for the next batch.
+		m_vecelevel.clear();
+		m_vecnOffset.clear();
+		m_str.clear();
+	}
+
+private:
+	std::size_t m_cchFlushThreshold;
+	std::string m_str; // Lines are terminated by '\n'
+	std::vector<std::uint32_t> m_vecnOffset; // Start of each line in m_str
+	std::vector<EConsoleLevel> m_vecelevel;
+	bool m_bFlushScheduled = false;
+
+	template<typename... Rng>
+	void Append(EConsoleLevel elevel, Rng&&... rng) & noexcept {
+		tc::cont_emplace_back(m_vecnOffset, tc::explicit_cast<std::uint32_t>(tc::size(m_str)));
+		tc::cont_emplace_back(m_vecelevel, elevel);
+		tc::append(m_str, std::forward<Rng>(rng)..., "\n");
+		if(m_cchFlushThreshold <= tc::size(m_str)) {
+			flush();
+		} else if(!m_bFlushScheduled) {
+			static auto const fnScheduleMicrotask = marshal_detail::LookupModuleFunction("tc_js_log_detail_js_ScheduleMicrotask", "js_log.js");
+			m_bFlushScheduled = true;
+			fnScheduleMicrotask(OnMicrotask);
+		}
+	}
+
+	TC_JS_MEMBER_FUNCTION(js_buffered_console, OnMicrotask, void, ()) {
+		m_bFlushScheduled = false;
+		flush();
+	}
+};
+} // namespace no_adl
+using no_adl::js_buffered_console;
+
+// Process-wide instance, e.g. to replace tc::js::console in code which logs a lot.
+inline js_buffered_console& buffered_console() noexcept {
+	static js_buffered_console s_console;
+	return s_console;
+}
+} // namespace tc::jst
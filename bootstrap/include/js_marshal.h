@@ -0,0 +1,193 @@
+#pragma once
+
+#include <emscripten/val.h>
+#include <emscripten/wire.h>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "explicit_cast.h"
+#include "noncopyable.h"
+#include "range_defines.h"
+#include "range.h"
+#include "tc_move.h"
+#include "type_traits.h"
+#include "js_types.h"
+#include "js_bootstrap.h"
+#include "js_marshal_detail.h"
+
+namespace tc::jst::struct_detail {
+// Must match tc_js_marshal_detail_js_CreateStructViewClass.
+enum class EViewField { none, float64, float32, int32, uint32, int16, uint16, int8, uint8, boolean };
+
+template<typename M>
+constexpr EViewField ViewField() noexcept {
+	if constexpr(IsJsIntegralEnum<M>::value) {
+		return ViewField<std::underlying_type_t<M>>();
+	} else if constexpr(std::is_same<M, bool>::value) {
+		return EViewField::boolean;
+	} else if constexpr(std::is_same<M, double>::value) {
+		return EViewField::float64;
+	} else if constexpr(std::is_same<M, float>::value) {
+		return EViewField::float32;
+	} else if constexpr(std::is_integral<M>::value && sizeof(M) <= 4) {
+		constexpr int c_iSize = 4 == sizeof(M) ? 0 : 2 == sizeof(M) ? 1 : 2;
+		return static_cast<EViewField>(static_cast<int>(EViewField::int32) + 2 * c_iSize + (std::is_signed<M>::value ? 0 : 1));
+	} else {
+		return EViewField::none; // e.g. 64-bit integers, which JS numbers cannot represent, or strings
+	}
+}
+
+template<typename M>
+inline constexpr EViewField c_eviewfield = ViewField<M>();
+} // namespace tc::jst::struct_detail
+
+namespace tc::jst {
+namespace no_adl {
+// UTF-8 encoded strings packed into a single buffer. Behaves as a random access range of std::string_view.
+struct js_packed_strings final : private tc::noncopyable {
+	js_packed_strings(js_packed_strings&&) noexcept = default;
+	js_packed_strings& operator=(js_packed_strings&&) noexcept = default;
+
+	auto begin() const& noexcept { return m_vecsv.begin(); }
+	auto end() const& noexcept { return m_vecsv.end(); }
+	std::size_t size() const& noexcept { return m_vecsv.size(); }
+	std::string_view operator[](std::size_t i) const& noexcept { return m_vecsv[i]; }
+
+private:
+	// Layout is defined by tc_js_marshal_detail_js_EncodeStringArray:
+	// uint32 count, uint32 offsets[count + 1], UTF-8 characters without terminators.
+	explicit js_packed_strings(marshal_detail::PointerNumber p) noexcept
+		: m_pn(marshal_detail::TakeOwnership<std::uint32_t>(p))
+	{
+		std::uint32_t const n = m_pn.get()[0];
+		std::uint32_t const* const pnOffset = m_pn.get() + 1;
+		char const* const pch = reinterpret_cast<char const*>(pnOffset + n + 1);
+		m_vecsv.reserve(n);
+		for(std::uint32_t i = 0; i < n; ++i) {
+			m_vecsv.emplace_back(pch + pnOffset[i], pnOffset[i + 1] - pnOffset[i]);
+		}
+	}
+
+	marshal_detail::unique_malloc_ptr<std::uint32_t> m_pn;
+	std::vector<std::string_view> m_vecsv;
+
+	friend js_packed_strings to_packed_utf8(tc::js::Array<js_string> const& jarrstr) noexcept;
+	template<typename V> friend js_packed_strings to_packed_utf8_keys(tc::js::Record<js_string, V> const& jrec) noexcept;
+};
+
+// Converts all strings in the array with a single call into JS instead of one call and one allocation per element.
+inline js_packed_strings to_packed_utf8(tc::js::Array<js_string> const& jarrstr) noexcept {
+	static auto const fnEncode = marshal_detail::LookupModuleFunction("tc_js_marshal_detail_js_EncodeStringArray");
+	return js_packed_strings(fnEncode(jarrstr).template as<marshal_detail::PointerNumber>());
+}
+
+// Zero-copy JS typed array over C++ memory, e.g. to hand a large buffer to JS without copying it.
+// Growing the wasm memory, which any allocation may do, detaches all typed arrays over it. get() therefore
+// creates a new typed array if the memory has grown since the last one was created. JS must not keep the
+// typed array beyond the call it is passed to, and C++ must keep the span alive while JS accesses it.
+template<typename T>
+struct js_heap_view final {
+	explicit js_heap_view(std::span<T> span) noexcept : m_span(span) {}
+
+	tc::js::TypedArray<std::remove_const_t<T>> const& get() & noexcept {
+		std::size_t const nPages = __builtin_wasm_memory_size(0);
+		if(!m_ojtarr || nPages != m_nPages) {
+			m_ojtarr.emplace(emscripten::val(emscripten::typed_memory_view(m_span.size(), m_span.data())));
+			m_nPages = nPages;
+		}
+		return *m_ojtarr;
+	}
+
+	// False if the last typed array returned by get() has been detached.
+	bool valid() const& noexcept { return m_ojtarr && __builtin_wasm_memory_size(0) == m_nPages; }
+
+	std::span<T> span() const& noexcept { return m_span; }
+
+private:
+	std::span<T> m_span;
+	std::optional<tc::js::TypedArray<std::remove_const_t<T>>> m_ojtarr;
+	std::size_t m_nPages = 0;
+};
+
+// JS object whose properties read and write the fields of a C++ struct listed by TC_JS_STRUCT directly in wasm memory,
+// so JS code reading a few fields of a large C++ model does not pay for marshalling all of it.
+// Only fields of type double, float, bool, integral enums and integers of up to 32 bits are exposed.
+// Like CUniqueDetachableJsFunction, the destructor detaches the JS object: accessing its properties afterwards throws.
+// The view must therefore not outlive the struct.
+template<typename Struct, typename JsType = js_unknown>
+struct js_struct_view final : private tc::nonmovable, JsType {
+	explicit js_struct_view(Struct& s) noexcept
+		: JsType(ViewClass(s).new_(reinterpret_cast<marshal_detail::PointerNumber>(std::addressof(s))))
+	{}
+
+	~js_struct_view() {
+		static auto const fnDetach = marshal_detail::LookupModuleFunction("tc_js_marshal_detail_js_DetachStructView");
+		fnDetach(this->getEmval());
+	}
+
+private:
+	// Field offsets are the same for all objects of the struct, so the class is created from the first one.
+	static emscripten::val const& ViewClass(Struct const& s) noexcept {
+		static auto const emvalClass = [&]() noexcept {
+			static auto const fnCreateStructViewClass = marshal_detail::LookupModuleFunction("tc_js_marshal_detail_js_CreateStructViewClass");
+			emscripten::val emvalNames = emscripten::val::array();
+			std::vector<int> veciKind;
+			std::vector<std::uint32_t> vecnOffset;
+			std::apply([&](auto const&... field) noexcept {
+				([&]() noexcept {
+					using M = typename tc::remove_cvref_t<decltype(field)>::value_type;
+					if constexpr(struct_detail::EViewField::none != struct_detail::c_eviewfield<M>) {
+						std::uintptr_t const nOffset = reinterpret_cast<std::uintptr_t>(std::addressof(s.*field.m_pm)) - reinterpret_cast<std::uintptr_t>(std::addressof(s));
+						_ASSERTEQUAL(nOffset % alignof(M), 0u);
+						emvalNames.call<void>("push", emscripten::val(field.m_szName));
+						veciKind.emplace_back(static_cast<int>(struct_detail::c_eviewfield<M>));
+						vecnOffset.emplace_back(tc::explicit_cast<std::uint32_t>(nOffset));
+					}
+				}(), ...);
+			}, _tcjs_struct_fields(static_cast<Struct const*>(nullptr)));
+			return fnCreateStructViewClass(
+				emvalNames,
+				emscripten::typed_memory_view(tc::size(veciKind), veciKind.data()),
+				emscripten::typed_memory_view(vecnOffset.size(), vecnOffset.data())
+			);
+		}();
+		return emvalClass;
+	}
+};
+
+// Converts all keys of the record, in the order of Object.keys, with a single call into JS.
+template<typename V>
+js_packed_strings to_packed_utf8_keys(tc::js::Record<js_string, V> const& jrec) noexcept {
+	static auto const fnEncodeKeys = marshal_detail::LookupModuleFunction("tc_js_marshal_detail_js_EncodeRecordKeysUtf8");
+	return js_packed_strings(fnEncodeKeys(jrec).template as<marshal_detail::PointerNumber>());
+}
+} // namespace no_adl
+using no_adl::js_heap_view;
+using no_adl::js_packed_strings;
+using no_adl::js_struct_view;
+using no_adl::to_packed_utf8;
+using no_adl::to_packed_utf8_keys;
+
+// Creates a JS array of strings from a range of UTF-8 strings with a single call into JS.
+template<typename Rng, std::enable_if_t<std::is_convertible<tc::range_reference_t<Rng const&>, std::string_view>::value>* = nullptr>
+tc::js::Array<js_string> make_js_string_array(Rng const& rngstr) noexcept {
+	static auto const fnDecode = marshal_detail::LookupModuleFunction("tc_js_marshal_detail_js_DecodeStringArray");
+	marshal_detail::CArenaScope scope;
+	marshal_detail::CArenaVector<std::uint32_t> vecnOffset;
+	marshal_detail::CArenaVector<char> vecch;
+	tc::for_each(rngstr, [&](std::string_view sv) noexcept {
+		vecnOffset.push_back(tc::explicit_cast<std::uint32_t>(vecch.size()));
+		vecch.append(sv.data(), tc::size(sv));
+	});
+	auto const nStrings = vecnOffset.size();
+	vecnOffset.push_back(tc::explicit_cast<std::uint32_t>(vecch.size()));
+	return tc::js::Array<js_string>(fnDecode(vecnOffset.Pointer(), nStrings, vecch.Pointer()));
+}
+} // namespace tc::jst
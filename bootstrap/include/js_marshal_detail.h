@@ -0,0 +1,144 @@
+#pragma once
+
+#include <emscripten/val.h>
+#include <emscripten/wire.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <string>
+#include <type_traits>
+#include "noncopyable.h"
+#include "range_defines.h"
+
+// Primitives shared by the bulk marshalling code in js_marshal.h and js_bootstrap.h.
+// The JS side lives in js_marshal.js, the C++ side in js_marshal.cpp.
+namespace tc::jst {
+namespace marshal_detail {
+void EnsureJsMarshalCppIsLinked();
+
+using PointerNumber = std::uintptr_t;
+
+// Functions defined by the other bootstrap JS files are looked up the same way, szPreJs names the file for the error message.
+inline emscripten::val LookupModuleFunction(char const* szName, char const* szPreJs = "js_marshal.js") noexcept {
+	EnsureJsMarshalCppIsLinked();
+	auto fn = emscripten::val::module_property(szName);
+	if(fn.isUndefined()) {
+		emscripten::val::global("console").call<void>("error",
+			std::string("Unable to find ") + szName + " from " + szPreJs + ", did you pass '--pre-js " + szPreJs + "' flags to em++?"
+		);
+		_ASSERTFALSE;
+	}
+	return fn;
+}
+
+// String literal as a template argument, e.g. to compile a JS function once per property name.
+template<std::size_t N>
+struct SName final {
+	constexpr SName(char const (&ach)[N]) noexcept {
+		std::copy_n(ach, N, m_ach);
+	}
+	char m_ach[N];
+};
+
+namespace no_adl {
+struct FFree final {
+	void operator()(void* p) const& noexcept { std::free(p); }
+};
+} // namespace no_adl
+using no_adl::FFree;
+
+// Buffers allocated by JS via tc_js_marshal_detail_Allocate.
+template<typename T>
+using unique_malloc_ptr = std::unique_ptr<T, FFree>;
+
+template<typename T>
+unique_malloc_ptr<T> TakeOwnership(PointerNumber p) noexcept {
+	return unique_malloc_ptr<T>(reinterpret_cast<T*>(p));
+}
+
+// Handles created by tc_js_marshal_detail_js_ToHandle in js_marshal.js are owned by C++.
+static_assert(sizeof(emscripten::internal::EM_VAL) == sizeof(std::uint32_t));
+
+inline emscripten::val TakeHandle(std::uint32_t nHandle) noexcept {
+	return emscripten::val::take_ownership(reinterpret_cast<emscripten::internal::EM_VAL>(static_cast<std::uintptr_t>(nHandle)));
+}
+
+// The opposite direction: JS takes ownership of the returned handle with tc_js_marshal_detail_js_TakeHandle, so C++ need not
+// keep emval alive until JS has read the handle.
+inline std::uint32_t ReleaseHandle(emscripten::val const& emval) noexcept {
+	emscripten::internal::_emval_incref(emval.as_handle());
+	return static_cast<std::uint32_t>(reinterpret_cast<std::uintptr_t>(emval.as_handle()));
+}
+
+// Scratch memory for the temporary payload of a single transfer between C++ and JS, e.g. numbers read from a JS iterator.
+// Both C++ (ArenaAllocate) and JS (tc_js_marshal_detail_js_ArenaAllocate) allocate by bumping a pointer, so steady-state
+// transfers neither call malloc nor free. JS only calls into C++ when the current block of the arena is full.
+// Allocations are released when the innermost CArenaScope ends, so the payload must be consumed within it.
+// Blocks are kept after the scope ends, except that the outermost scope frees blocks beyond a fixed total size,
+// so a single large transfer does not pin its memory for the lifetime of the thread.
+// JS passes payloads in the arena as pointers and accesses them through the HEAP* views of emscripten, which are
+// refreshed when the wasm memory grows, instead of creating a typed_memory_view per call.
+PointerNumber ArenaAllocate(std::size_t cb, std::size_t nAlign) noexcept;
+
+template<typename T>
+std::span<T> ArenaSpan(std::size_t n) noexcept {
+	static_assert(std::is_trivially_destructible<T>::value);
+	return std::span<T>(reinterpret_cast<T*>(ArenaAllocate(n * sizeof(T), alignof(T))), n);
+}
+
+namespace no_adl {
+// Growable array in the arena for payloads whose size is not known in advance, e.g. one element per element of a C++ range.
+// Growing copies the elements into an allocation twice as large, the old one is only released with the enclosing CArenaScope.
+template<typename T>
+struct CArenaVector final : private tc::noncopyable {
+	static_assert(std::is_trivially_copyable<T>::value);
+
+	void push_back(T const& t) & noexcept {
+		Reserve(m_n + 1);
+		m_span[m_n++] = t;
+	}
+
+	void append(T const* pt, std::size_t n) & noexcept {
+		Reserve(m_n + n);
+		if(0 < n) {
+			std::memcpy(m_span.data() + m_n, pt, n * sizeof(T));
+		}
+		m_n += n;
+	}
+
+	std::size_t size() const& noexcept { return m_n; }
+	T const& operator[](std::size_t i) const& noexcept { return m_span[i]; }
+	PointerNumber Pointer() const& noexcept { return reinterpret_cast<PointerNumber>(m_span.data()); }
+
+private:
+	std::span<T> m_span;
+	std::size_t m_n = 0;
+
+	void Reserve(std::size_t n) & noexcept {
+		if(m_span.size() < n) {
+			auto const spanNew = ArenaSpan<T>(std::max({n, 2 * m_span.size(), std::size_t(16)}));
+			if(0 < m_n) {
+				std::memcpy(spanNew.data(), m_span.data(), m_n * sizeof(T));
+			}
+			m_span = spanNew;
+		}
+	}
+};
+
+struct CArenaScope final : private tc::nonmovable {
+	CArenaScope() noexcept;
+	~CArenaScope();
+
+private:
+	std::size_t m_iBlock;
+	std::uint32_t m_nCur;
+};
+} // namespace no_adl
+using no_adl::CArenaScope;
+using no_adl::CArenaVector;
+} // namespace marshal_detail
+} // namespace tc::jst
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <emscripten/val.h>
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include "range_defines.h"
+#include "range.h"
+#include "tc_move.h"
+#include "type_list.h"
+#include "type_traits.h"
+#include "js_types.h"
+#include "js_marshal_detail.h"
+
+namespace tc::jst {
+namespace path_detail {
+// Every chain of names is a distinct type with its own compiled JS function.
+using marshal_detail::SName;
+
+// Property access if c_nArgs < 0, otherwise a method call with c_nArgs arguments.
+// If c_bOptional, the object the step is applied to may be undefined or null, and then the chain evaluates to undefined.
+template<SName Name, int nArgs, bool bOptional>
+struct SStep final {
+	static constexpr char const* c_szName = Name.m_ach;
+	static constexpr int c_nArgs = nArgs;
+	static constexpr bool c_bOptional = bOptional;
+};
+
+// Property or method of Object declared in TypeScript. stage1 emits one per property and per method which is not overloaded,
+// in _tcjs_definitions::_tcjs_path of the declaring class, e.g. ts::VariableStatement::_tcjs_path::declarationList.
+template<SName Name, bool bCall, typename Object, typename Result, typename... Params>
+struct STypedStep final {
+	static constexpr auto c_name = Name;
+	static constexpr int c_nArgs = bCall ? static_cast<int>(sizeof...(Params)) : -1;
+	using object_type = Object;
+	using result_type = Result;
+	using params_type = tc::type::list<Params...>;
+};
+
+// The class whose steps can be applied to a value of type T. Values of optional object types end the chain if they are
+// undefined or null.
+template<typename T, typename = void>
+struct PathObject {};
+
+template<typename T>
+struct PathObject<js_ref<T>> {
+	using type = T;
+	static constexpr bool c_bOptional = false;
+};
+
+template<typename... Ts>
+struct PathObject<js_union<Ts...>, tc::void_t<typename js_union<Ts...>::option_like_type>> {
+	using type = typename PathObject<typename js_union<Ts...>::option_like_type>::type;
+	static constexpr bool c_bOptional = true;
+};
+
+// Result of a chain which may have ended at an intermediate undefined or null.
+template<typename T>
+struct MakeOptional { using type = js_optional<T>; };
+
+template<typename... Ts>
+struct MakeOptional<js_union<Ts...>> {
+	using type = std::conditional_t<js_union<Ts...>::has_undefined, js_union<Ts...>, js_union<js_undefined, Ts...>>;
+};
+
+template<>
+struct MakeOptional<js_unknown> { using type = js_unknown; };
+
+template<>
+struct MakeOptional<void> { using type = void; };
+
+template<typename... Params, typename... ArgsCall>
+std::tuple<Params...> MakeArgs(tc::type::list<Params...>, ArgsCall&&... args) noexcept {
+	static_assert(sizeof...(Params) == sizeof...(ArgsCall), "A method step needs one argument per parameter");
+	return std::tuple<Params...>(std::forward<ArgsCall>(args)...);
+}
+
+template<typename... Steps>
+emscripten::val const& CompiledPath() noexcept {
+	static auto const emvalFunction = []() noexcept {
+		emscripten::val emvalNames = emscripten::val::array();
+		(emvalNames.call<void>("push", emscripten::val(Steps::c_szName)), ...);
+		std::array<int, sizeof...(Steps)> const anArgs{Steps::c_nArgs...};
+		std::array<int, sizeof...(Steps)> const anOptional{Steps::c_bOptional...};
+		static auto const fnCompilePath = marshal_detail::LookupModuleFunction("tc_js_marshal_detail_js_CompilePath");
+		return fnCompilePath(
+			emvalNames,
+			emscripten::typed_memory_view(tc::size(anArgs), anArgs.data()),
+			emscripten::typed_memory_view(tc::size(anOptional), anOptional.data())
+		);
+	}();
+	return emvalFunction;
+}
+} // namespace path_detail
+
+namespace no_adl {
+template<typename Current, bool bOptional, typename ListSteps, typename TupleArgs>
+struct js_path_expr;
+
+// Chain of property accesses and method calls which is only evaluated by get, with a single call into JS.
+// The JS function evaluating the chain is compiled once per chain of steps, the arguments of calls are passed to it.
+// Only the final value is converted to C++, intermediate objects never get a handle.
+template<typename Current, bool bOptional, typename... Steps, typename... Args>
+struct js_path_expr<Current, bOptional, tc::type::list<Steps...>, std::tuple<Args...>> final {
+	js_path_expr(emscripten::val emvalRoot, std::tuple<Args...> tupleargs) noexcept
+		: m_emvalRoot(tc_move(emvalRoot))
+		, m_tupleargs(tc_move(tupleargs))
+	{}
+
+	// Step is one of the steps emitted by stage1, declared by the class of the current value or by one of its bases.
+	// Arguments of method steps are converted to the parameter types of the method.
+	template<typename Step, typename... ArgsCall>
+	auto step(ArgsCall&&... args) && noexcept {
+		using PathObject = path_detail::PathObject<Current>;
+		static_assert(std::is_convertible<typename PathObject::type*, typename Step::object_type*>::value, "Step is not declared by the class of the current value or its bases");
+		static_assert(0 <= Step::c_nArgs || 0 == sizeof...(ArgsCall), "A property step takes no arguments");
+		auto tupleargs = std::tuple_cat(tc_move(m_tupleargs), path_detail::MakeArgs(typename Step::params_type(), std::forward<ArgsCall>(args)...));
+		return js_path_expr<
+			typename Step::result_type,
+			bOptional || PathObject::c_bOptional,
+			tc::type::list<Steps..., path_detail::SStep<Step::c_name, Step::c_nArgs, PathObject::c_bOptional>>,
+			decltype(tupleargs)
+		>(tc_move(m_emvalRoot), tc_move(tupleargs));
+	}
+
+	// The type of the last step, or an optional of it if an intermediate value may have been undefined or null.
+	using result_type = std::conditional_t<bOptional, typename path_detail::MakeOptional<Current>::type, Current>;
+
+	result_type get() && noexcept {
+		static_assert(0 < sizeof...(Steps));
+		return std::apply([&](Args const&... args) noexcept -> result_type {
+			if constexpr(std::is_void<result_type>::value) {
+				path_detail::CompiledPath<Steps...>()(m_emvalRoot, args...);
+			} else {
+				return path_detail::CompiledPath<Steps...>()(m_emvalRoot, args...).template as<result_type>();
+			}
+		}, m_tupleargs);
+	}
+
+private:
+	emscripten::val m_emvalRoot;
+	std::tuple<Args...> m_tupleargs;
+};
+} // namespace no_adl
+
+// Starts a lazy chain, e.g. with using ts = tc::js::ts,
+//	js_path(jDiagnostic).step<ts::Diagnostic::_tcjs_path::file>()
+//		.step<ts::SourceFile::_tcjs_path::getLineAndCharacterOfPosition>(nPos)
+//		.step<ts::LineAndCharacter::_tcjs_path::line>().get()
+// evaluates jDiagnostic.file?.getLineAndCharacterOfPosition(nPos).line with a single call into JS instead of one per link,
+// and returns js_optional<double> because file is optional. The steps carry the names and types of the TypeScript
+// declarations, so a chain compiles only if each step is declared by the class of the value it is applied to.
+template<typename T, std::enable_if_t<emscripten_interop_detail::IsEmvalWrapper<T>::value>* = nullptr>
+no_adl::js_path_expr<T, false, tc::type::list<>, std::tuple<>> js_path(T const& jobj) noexcept {
+	return {jobj.getEmval(), std::tuple<>()};
+}
+} // namespace tc::jst
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <emscripten/val.h>
+#include <optional>
 #include <string>
 #include <utility>
 #include <type_traits>
@@ -19,6 +20,9 @@ private:
 protected:
 	explicit IObject(emscripten::val& _emval) noexcept : m_emval(_emval) {}
 
+	// For bulk operations implemented in JS which take the object itself as an argument.
+	emscripten::val const& _getEmval() noexcept { return m_emval; }
+
 	template<typename T>
 	T _this() noexcept {
 		static_assert(IsJsInteropable<T>::value);
@@ -176,6 +180,33 @@ public:
 };
 } // namespace no_adl
 
+namespace js_ref_detail {
+template<typename T>
+struct target { using type = T; };
+
+template<typename T>
+struct target<js_ref<T>> { using type = T; };
+} // namespace js_ref_detail
+
+// Checked cast, e.g. js_dynamic_cast<tc::js::HTMLElement>(jnode). Returns std::nullopt unless the object is an instanceof U.
+// U must have a JS constructor, which stage1 generates as _tcjs_constructor for classes and for interfaces declared together
+// with a variable holding their constructor. Only the constructor lookup is cached: the result of instanceof is not, because
+// caching it per object would itself need a call into JS to identify the object, so every check is one call into JS.
+// Casts to a base class are not checked and do not call into JS.
+template<typename To, typename T>
+std::optional<js_ref<typename js_ref_detail::target<To>::type>> js_dynamic_cast(js_ref<T> const& jsref) noexcept {
+	using U = typename js_ref_detail::target<To>::type;
+	if constexpr(std::is_convertible<T*, U*>::value) {
+		return js_ref<U>(jsref);
+	} else {
+		// The tag only matches the constructor declared by U itself, not one inherited from a base class.
+		if(jsref.getEmval().instanceof(U::_tcjs_constructor(std::type_identity<U>()))) {
+			return js_ref<U>(jsref.getEmval());
+		}
+		return std::nullopt;
+	}
+}
+
 namespace no_adl {
 template<typename T>
 struct IsJsInteropable<T, std::enable_if_t<
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <emscripten/val.h>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include "noncopyable.h"
+#include "range_defines.h"
+#include "tc_move.h"
+#include "js_types.h"
+#include "js_bootstrap.h"
+#include "js_marshal_detail.h"
+
+namespace tc::jst {
+namespace no_adl {
+// Reads a node Readable, a WHATWG ReadableStream or any async iterable of Uint8Array, ArrayBuffer or string chunks
+// directly into a C++ buffer. Strings are encoded as UTF-8 in JS, chunks never become js_string or js_unknown in C++.
+// The stream is only pulled when read is called, so a slow consumer applies backpressure to the source.
+struct js_stream_reader final : private tc::noncopyable {
+	explicit js_stream_reader(js_unknown const& junkStream) noexcept {
+		static auto const fnCreateReader = marshal_detail::LookupModuleFunction("tc_js_stream_detail_js_CreateReader", "js_stream.js");
+		m_emval = fnCreateReader(junkStream.getEmval());
+	}
+	js_stream_reader(js_stream_reader&&) noexcept = default;
+	js_stream_reader& operator=(js_stream_reader&&) noexcept = default;
+
+	// Resolves to the number of bytes copied into spanby, which is 0 only at the end of the stream. Chunks larger than
+	// spanby are returned by subsequent reads. spanby must stay valid until the Promise is settled,
+	// and read must not be called again before.
+	tc::js::Promise<double> read(std::span<std::byte> spanby) & noexcept {
+		_ASSERT(!spanby.empty());
+		return tc::js::Promise<double>(m_emval.call<emscripten::val>("read", reinterpret_cast<std::uintptr_t>(spanby.data()), spanby.size()));
+	}
+
+	// Releases the source, e.g. if the consumer stops before the end of the stream.
+	tc::js::Promise<void> cancel() & noexcept {
+		return tc::js::Promise<void>(m_emval.call<emscripten::val>("cancel"));
+	}
+
+private:
+	emscripten::val m_emval = emscripten::val::undefined();
+};
+
+// Writes C++ buffers to a node Writable or a WHATWG WritableStream.
+struct js_stream_writer final : private tc::noncopyable {
+	explicit js_stream_writer(js_unknown const& junkStream) noexcept {
+		static auto const fnCreateWriter = marshal_detail::LookupModuleFunction("tc_js_stream_detail_js_CreateWriter", "js_stream.js");
+		m_emval = fnCreateWriter(junkStream.getEmval());
+	}
+	js_stream_writer(js_stream_writer&&) noexcept = default;
+	js_stream_writer& operator=(js_stream_writer&&) noexcept = default;
+
+	// The bytes are copied before write returns, so spanby may be reused immediately. The Promise resolves
+	// when the stream accepts more data. Writing before that only grows the buffer of the stream, there is no backpressure.
+	tc::js::Promise<void> write(std::span<std::byte const> spanby) & noexcept {
+		return tc::js::Promise<void>(m_emval.call<emscripten::val>("write", reinterpret_cast<std::uintptr_t>(spanby.data()), spanby.size()));
+	}
+
+	// Resolves when all data has been flushed to the underlying sink.
+	tc::js::Promise<void> end() & noexcept {
+		return tc::js::Promise<void>(m_emval.call<emscripten::val>("end"));
+	}
+
+private:
+	emscripten::val m_emval = emscripten::val::undefined();
+};
+} // namespace no_adl
+using no_adl::js_stream_reader;
+using no_adl::js_stream_writer;
+} // namespace tc::jst
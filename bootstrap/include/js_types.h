@@ -2,6 +2,7 @@
 #include <emscripten/val.h>
 #include <emscripten/wire.h>
 #include <string>
+#include <string_view>
 #include <type_traits>
 #include <utility>
 #include "algorithm.h"
@@ -12,6 +13,7 @@
 #include "type_list.h"
 #include "type_traits.h"
 #include "tc_move.h"
+#include "js_marshal_detail.h"
 
 namespace tc::jst {
 namespace no_adl {
@@ -161,9 +163,10 @@ struct js_union : js_union_detail::CDetectOptionLike<void, Ts...> {
 
 	static inline constexpr auto has_undefined = tc::type::find_unique<ListTs, js_undefined>::found;
 	static inline constexpr auto has_null = tc::type::find_unique<ListTs, js_null>::found;
-	static inline constexpr auto has_string = tc::type::find_unique<ListTs, js_string>::found;
+	// Enums are represented by their values: integral enums by numbers, heterogeneous enums by strings or numbers.
+	static inline constexpr auto has_string = tc::type::find_unique<ListTs, js_string>::found || (IsJsHeterogeneousEnum<Ts>::value || ...);
 	static inline constexpr auto has_bool = tc::type::find_unique<ListTs, bool>::found;
-	static inline constexpr auto has_number = tc::type::find_unique<ListTs, double>::found;
+	static inline constexpr auto has_number = tc::type::find_unique<ListTs, double>::found || ((IsJsIntegralEnum<Ts>::value || IsJsHeterogeneousEnum<Ts>::value) || ...);
 
 	explicit js_union(emscripten::val const& _emval) noexcept : m_emval(_emval) { assertEmvalInRange(); }
 	explicit js_union(emscripten::val&& _emval) noexcept : m_emval(tc_move(_emval)) { assertEmvalInRange(); }
@@ -306,11 +309,11 @@ struct js_string final {
 	emscripten::val const& getEmval() const& noexcept { return m_emval; }
 	emscripten::val&& getEmval() && noexcept { return tc_move(m_emval); }
 
-	template<typename Rng, typename = std::enable_if_t<tc::is_explicit_castable<std::string, Rng&&>::value>>
-	explicit js_string(Rng&& rng) noexcept : m_emval(
-		// TODO: avoid allocating std::string (we may have to duplicate parts of embind)
-		tc::explicit_cast<std::string>(std::forward<Rng>(rng))
-	) {
+	// Not for js_string itself, which explicitly converts to std::string as well, but must be copied instead.
+	template<typename Rng, typename = std::enable_if_t<
+		tc::is_explicit_castable<std::string, Rng&&>::value && !std::is_same<tc::remove_cvref_t<Rng>, js_string>::value
+	>>
+	explicit js_string(Rng&& rng) noexcept : m_emval(FromUtf8(std::forward<Rng>(rng))) {
 	}
 
 	int length() const& noexcept { return m_emval["length"].as<int>(); }
@@ -323,6 +326,24 @@ struct js_string final {
 
 private:
 	emscripten::val m_emval;
+
+	// Decodes the UTF-8 in wasm memory with a single call into JS instead of copying it into a std::string for embind.
+	// Contiguous strings are read in place, other character ranges are collected in the marshalling arena first.
+	template<typename Rng>
+	static emscripten::val FromUtf8(Rng&& rng) noexcept {
+		static auto const fnUtf8ToString = marshal_detail::LookupModuleFunction("tc_js_marshal_detail_js_Utf8ToString");
+		if constexpr(std::is_convertible<Rng&&, std::string_view>::value) {
+			std::string_view const sv(std::forward<Rng>(rng));
+			return fnUtf8ToString(reinterpret_cast<marshal_detail::PointerNumber>(sv.data()), tc::size(sv));
+		} else {
+			marshal_detail::CArenaScope scope;
+			marshal_detail::CArenaVector<char> vecch;
+			tc::for_each(std::forward<Rng>(rng), [&](char const ch) noexcept {
+				vecch.push_back(ch);
+			});
+			return fnUtf8ToString(vecch.Pointer(), vecch.size());
+		}
+	}
 };
 } // namespace no_adl
 using no_adl::js_union;
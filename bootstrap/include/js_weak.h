@@ -0,0 +1,158 @@
+#pragma once
+
+#include <emscripten/val.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "noncopyable.h"
+#include "range_defines.h"
+#include "range.h"
+#include "tc_move.h"
+#include "js_types.h"
+#include "js_marshal_detail.h"
+#include "js_intern.h"
+
+namespace tc::jst {
+namespace weak_detail {
+inline emscripten::val CreateWeakCache(std::uint32_t* pnPending) noexcept {
+	static auto const creator = marshal_detail::LookupModuleFunction("tc_js_weak_detail_js_CreateWeakCache", "js_weak.js");
+	return creator(reinterpret_cast<std::uintptr_t>(pnPending));
+}
+} // namespace weak_detail
+
+namespace no_adl {
+// Refers to a JS object without keeping it alive, like a JS WeakRef.
+template<typename T>
+struct js_weak_ref final {
+	static_assert(tc::is_instance_or_derived<js_ref, T>::value); // WeakRef only accepts objects
+
+	explicit js_weak_ref(T const& t) noexcept {
+		static auto const emvalWeakRef = emscripten::val::global("WeakRef");
+		m_emval = emvalWeakRef.new_(t);
+	}
+
+	// std::nullopt if the object has been collected. The returned wrapper keeps the object alive again.
+	std::optional<T> lock() const& noexcept {
+		emscripten::val emval = m_emval.call<emscripten::val>("deref");
+		if(emval.isUndefined()) {
+			return std::nullopt;
+		}
+		return T(tc_move(emval));
+	}
+
+private:
+	emscripten::val m_emval = emscripten::val::undefined();
+};
+
+// Caches C++ values per JS object without keeping the objects alive, e.g. data derived from a ts::SourceFile.
+// Entries are keyed by identity_id. A FinalizationRegistry records the IDs of collected keys in JS and counts them in a
+// member of the cache, so checking for them does not call into JS. Their entries are removed in one batch by purge,
+// which every inserting member calls first. Like all finalization in JS, collected keys are only reported after
+// the current task has ended, i.e., after C++ code has returned to the JS event loop.
+// The values are owned by C++ and JS cannot see them: a value holding a js_ref to its own key, or to an object which
+// refers back to the key, e.g. a child node referring to its parent, keeps the key alive, and the entry is never removed.
+template<typename K, typename V>
+struct js_weak_cache final : private tc::nonmovable {
+	static_assert(tc::is_instance_or_derived<js_ref, K>::value);
+
+	js_weak_cache() noexcept : m_emval(weak_detail::CreateWeakCache(&m_nPending)) {}
+
+	~js_weak_cache() {
+		m_emval.call<void>("dispose");
+	}
+
+	// Returns nullptr if there is no entry for k.
+	V* find(K const& k) & noexcept {
+		auto const it = m_map.find(identity_id(k));
+		return m_map.end() == it ? nullptr : std::addressof(it->second);
+	}
+
+	// Like std::unordered_map::try_emplace, returns the value for k and whether it has been inserted.
+	template<typename... Args>
+	std::pair<V&, bool> try_emplace(K const& k, Args&&... args) & noexcept {
+		purge();
+		auto const [it, bInserted] = m_map.try_emplace(identity_id(k), std::forward<Args>(args)...);
+		if(bInserted) {
+			m_emval.call<void>("register", k, static_cast<double>(static_cast<std::uint64_t>(it->first)));
+		}
+		return {it->second, bInserted};
+	}
+
+	// Memoization: returns the cached value for k, or inserts func(k) if there is none.
+	template<typename Func>
+	V& find_or_create(K const& k, Func func) & noexcept {
+		purge();
+		js_identity_id const id = identity_id(k);
+		if(auto const it = m_map.find(id); m_map.end() != it) {
+			return it->second;
+		}
+		V& v = m_map.try_emplace(id, func(k)).first->second;
+		m_emval.call<void>("register", k, static_cast<double>(static_cast<std::uint64_t>(id)));
+		return v;
+	}
+
+	bool erase(K const& k) & noexcept {
+		if(0 == m_map.erase(identity_id(k))) {
+			return false;
+		}
+		m_emval.call<void>("unregister", k);
+		return true;
+	}
+
+	// Removes the entries of all keys which have been reported as collected, with a single call into JS.
+	// Does not call into JS if there are none.
+	void purge() & noexcept {
+		if(0 != m_nPending) {
+			marshal_detail::CArenaScope scope;
+			auto const spandbl = marshal_detail::ArenaSpan<double>(m_nPending);
+			m_emval.call<void>("take", reinterpret_cast<marshal_detail::PointerNumber>(spandbl.data()), tc::size(spandbl));
+			tc::for_each(spandbl, [&](double dbl) noexcept {
+				m_map.erase(static_cast<js_identity_id>(dbl));
+			});
+		}
+	}
+
+	// Includes entries of collected keys which have not been purged yet.
+	std::size_t size() const& noexcept { return m_map.size(); }
+
+private:
+	std::uint32_t m_nPending = 0; // Written by js_weak.js when keys are collected.
+	emscripten::val m_emval;
+	std::unordered_map<js_identity_id, V> m_map;
+};
+} // namespace no_adl
+using no_adl::js_weak_ref;
+using no_adl::js_weak_cache;
+
+namespace property_detail {
+// Getter of a readonly property, or of a method without parameters, memoized by tcjs, see SJsClass::m_bMemoize in stage1.
+// The value is stored in JS, in a WeakMap per property, so a read is a single call into JS like an ordinary getter, but
+// JS neither reads the property nor calls the method again, and the value is dropped together with the JS object.
+// Properties which are readonly in typescript but change in JS, and methods with side effects, must not be memoized.
+template<marshal_detail::SName Name, bool bCall>
+emscripten::val const& MemoizedGetter() noexcept {
+	static auto const emvalGetter = []() noexcept {
+		static auto const fnCreateMemoizedGetter = marshal_detail::LookupModuleFunction("tc_js_weak_detail_js_CreateMemoizedGetter", "js_weak.js");
+		return fnCreateMemoizedGetter(emscripten::val(Name.m_ach), bCall);
+	}();
+	return emvalGetter;
+}
+
+template<typename T, marshal_detail::SName Name>
+T MemoizedProperty(emscripten::val const& emval) noexcept {
+	static_assert(IsJsInteropable<T>::value);
+	return MemoizedGetter<Name, false>()(emval).template as<T>();
+}
+
+template<typename T, marshal_detail::SName Name>
+T MemoizedMethod(emscripten::val const& emval) noexcept {
+	static_assert(IsJsInteropable<T>::value);
+	return MemoizedGetter<Name, true>()(emval).template as<T>();
+}
+} // namespace property_detail
+} // namespace tc::jst
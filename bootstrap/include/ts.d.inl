@@ -7786,6 +7786,11 @@ namespace tc::js_defs {
 	};
 	struct _impl_js_jts_dVariableDeclarationList : virtual _impl_js_jts_dNode {
 		struct _tcjs_definitions {
+			struct _tcjs_path {
+				using kind = tc::jst::path_detail::STypedStep<"kind", false, _impl_js_jts_dVariableDeclarationList, _js_jts_dSyntaxKind /*SyntaxKind.VariableDeclarationList*/>;
+				using parent = tc::jst::path_detail::STypedStep<"parent", false, _impl_js_jts_dVariableDeclarationList, js_union<_js_jts_dForInStatement, _js_jts_dForOfStatement, _js_jts_dForStatement, _js_jts_dVariableStatement>>;
+				using declarations = tc::jst::path_detail::STypedStep<"declarations", false, _impl_js_jts_dVariableDeclarationList, js_unknown /*flags=524288: NodeArray<VariableDeclaration> (TypeReference=ts.NodeArray)*/>;
+			};
 		};
 		auto kind() noexcept;
 		void kind(_js_jts_dSyntaxKind /*SyntaxKind.VariableDeclarationList*/ v) noexcept;
@@ -7796,6 +7801,10 @@ namespace tc::js_defs {
 	};
 	struct _impl_js_jts_dVariableStatement : virtual _impl_js_jts_dStatement, virtual _impl_js_jts_dJSDocContainer {
 		struct _tcjs_definitions {
+			struct _tcjs_path {
+				using kind = tc::jst::path_detail::STypedStep<"kind", false, _impl_js_jts_dVariableStatement, _js_jts_dSyntaxKind /*SyntaxKind.VariableStatement*/>;
+				using declarationList = tc::jst::path_detail::STypedStep<"declarationList", false, _impl_js_jts_dVariableStatement, _js_jts_dVariableDeclarationList>;
+			};
 		};
 		auto kind() noexcept;
 		void kind(_js_jts_dSyntaxKind /*SyntaxKind.VariableStatement*/ v) noexcept;
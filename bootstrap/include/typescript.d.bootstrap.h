@@ -28,6 +28,7 @@ and limitations under the License.
 #include "js_types.h"
 #include "js_callback.h"
 #include "js_bootstrap.h"
+#include "js_path.h"
 
 #include "ts.d.inl"
 
@@ -0,0 +1,71 @@
+Module.tc_js_algorithm_detail_js_MakePredicate = function(iOperation, value, strProperty) {
+    // Order of operations has to match tc::jst::EJsPredicate.
+    let fn;
+    switch (iOperation) {
+        case 0: fn = x => x === value; break;
+        case 1: fn = x => x !== value; break;
+        case 2: fn = x => x < value; break;
+        case 3: fn = x => x <= value; break;
+        case 4: fn = x => x > value; break;
+        case 5: fn = x => x >= value; break;
+        case 6: fn = x => !!x; break;
+        default: throw new Error('Unknown predicate ' + iOperation);
+    }
+    if (strProperty.length === 0) {
+        return fn;
+    }
+    return x => fn(x[strProperty]);
+}
+
+Module.tc_js_algorithm_detail_js_Sum = function(arr) {
+    let sum = 0;
+    for (let i = 0; i < arr.length; ++i) {
+        sum += arr[i];
+    }
+    return sum;
+}
+
+Module.tc_js_algorithm_detail_js_Min = function(arr) {
+    // undefined for an empty array.
+    if (arr.length === 0) {
+        return undefined;
+    }
+    let min = arr[0];
+    for (let i = 1; i < arr.length; ++i) {
+        if (arr[i] < min) min = arr[i];
+    }
+    return min;
+}
+
+Module.tc_js_algorithm_detail_js_Max = function(arr) {
+    if (arr.length === 0) {
+        return undefined;
+    }
+    let max = arr[0];
+    for (let i = 1; i < arr.length; ++i) {
+        if (max < arr[i]) max = arr[i];
+    }
+    return max;
+}
+
+Module.tc_js_algorithm_detail_js_CountIf = function(arr, iOperation, value, strProperty) {
+    const fn = Module.tc_js_algorithm_detail_js_MakePredicate(iOperation, value, strProperty);
+    let n = 0;
+    for (let i = 0; i < arr.length; ++i) {
+        if (fn(arr[i])) ++n;
+    }
+    return n;
+}
+
+Module.tc_js_algorithm_detail_js_FindFirstIndexIf = function(arr, iOperation, value, strProperty) {
+    // -1 if there is no such element.
+    return arr.findIndex(Module.tc_js_algorithm_detail_js_MakePredicate(iOperation, value, strProperty));
+}
+
+Module.tc_js_algorithm_detail_js_Filter = function(arr, iOperation, value, strProperty) {
+    return arr.filter(Module.tc_js_algorithm_detail_js_MakePredicate(iOperation, value, strProperty));
+}
+
+Module.tc_js_algorithm_detail_js_MapProperty = function(arr, strProperty) {
+    return arr.map(x => x[strProperty]);
+}
@@ -13,6 +13,9 @@ Module.tc_js_callback_detail_js_CreateJsFunction = function(iFunctionPtr, iArgum
         iFunctionPtr = null;
         iArgumentPtr = null;
     }
+    fnWrapper.isDetached = function() {
+        return iFunctionPtr === null;
+    }
     fnWrapper.delete = function() {
         console.error("Callback's lifetime is managed from C++ only, delete() from JS is ignored");
         // TODO: should we allow passing ownership to JavaScript sometimes?
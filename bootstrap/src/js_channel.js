@@ -0,0 +1,74 @@
+// Producer side of tc::jst::js_channel (js_channel.h). The ring buffer lives in wasm memory, with -pthread in a
+// SharedArrayBuffer, so a C++ thread can consume the messages without any call from JS into C++.
+// Header layout, see tc::jst::channel_detail::SHeader: uint32 nWrite, nRead, bWaiting, bClosed, cbCapacity, pData.
+// nWrite and nRead count bytes and wrap around at 2^32, cbCapacity is a power of 2.
+// Frame layout: uint32 cb, uint32 nType, cb bytes of payload followed by at least one byte of padding to a multiple of 8.
+// A frame with nType 0xFFFFFFFF fills the end of the buffer when the next frame does not fit before wrapping around.
+
+Module.tc_js_channel_detail_js_CreateProducer = function(pHeader) {
+    const i32 = pHeader >> 2;
+    const cbCapacity = HEAPU32[i32 + 4];
+    const pData = HEAPU32[i32 + 5];
+    // Any frame fits if at most half of the buffer is used, including the padding frame before it.
+    const cbMessageMax = cbCapacity / 2 - 16;
+
+    function write(nType, cb, fnWritePayload) {
+        if (!(0 <= nType && nType < 0xFFFFFFFF)) {
+            throw new RangeError("Message type must be a uint32 less than 0xFFFFFFFF");
+        }
+        if (cb > cbMessageMax) {
+            throw new RangeError("Message of " + cb + " bytes exceeds the maximum of " + cbMessageMax + " bytes of the channel");
+        }
+        if (0 !== Atomics.load(HEAPU32, i32 + 3)) {
+            throw new Error("Channel is closed");
+        }
+        // Only the producer writes nWrite, the consumer only ever increases nRead, so the free space can only grow meanwhile.
+        const nWrite = HEAPU32[i32];
+        const nRead = Atomics.load(HEAPU32, i32 + 1);
+        const cbFrame = 8 + ((cb + 8) & ~7);
+        const ib = nWrite & (cbCapacity - 1);
+        const cbPadding = cbCapacity - ib < cbFrame ? cbCapacity - ib : 0;
+        if (cbCapacity - ((nWrite - nRead) >>> 0) < cbPadding + cbFrame) {
+            return false;
+        }
+        if (0 !== cbPadding) {
+            HEAPU32[(pData + ib) >> 2] = cbPadding - 8;
+            HEAPU32[((pData + ib) >> 2) + 1] = 0xFFFFFFFF;
+        }
+        const pFrame = pData + (0 !== cbPadding ? 0 : ib);
+        HEAPU32[pFrame >> 2] = cb;
+        HEAPU32[(pFrame >> 2) + 1] = nType;
+        fnWritePayload(pFrame + 8);
+        // Publishes the frame, Atomics.store is sequentially consistent, so the payload is visible before nWrite.
+        Atomics.store(HEAPU32, i32, (nWrite + cbPadding + cbFrame) >>> 0);
+        if (0 !== Atomics.load(HEAPU32, i32 + 2)) {
+            Atomics.notify(HEAP32, i32, 1);
+        }
+        return true;
+    }
+
+    return {
+        maxMessageSize: cbMessageMax,
+        // Returns false if the channel is full, the message is not written then. data may be a string, which is
+        // written as UTF-8, an ArrayBuffer, a typed array or DataView, whose bytes are copied, or undefined.
+        tryWrite: function(nType, data) {
+            if (data === undefined) {
+                return write(nType, 0, function(p) {});
+            } else if (typeof data === 'string') {
+                const cb = lengthBytesUTF8(data);
+                // stringToUTF8Array writes a terminator, which always fits into the padding.
+                return write(nType, cb, function(p) { stringToUTF8Array(data, HEAPU8, p, cb + 1); });
+            } else {
+                const viewby = ArrayBuffer.isView(data)
+                    ? new Uint8Array(data.buffer, data.byteOffset, data.byteLength)
+                    : new Uint8Array(data);
+                return write(nType, viewby.length, function(p) { HEAPU8.set(viewby, p); });
+            }
+        },
+        // No messages can be written afterwards. The consumer still reads the messages written before.
+        close: function() {
+            Atomics.store(HEAPU32, i32 + 3, 1);
+            Atomics.notify(HEAP32, i32, 1);
+        }
+    };
+}
@@ -0,0 +1,64 @@
+Module.tc_js_intern_detail_js_CreateInterner = function() {
+    const mapstrid = new Map();
+    const vecstr = [];
+
+    const intern = function(str) {
+        let id = mapstrid.get(str);
+        if (id === undefined) {
+            id = vecstr.length;
+            vecstr.push(str);
+            mapstrid.set(str, id);
+        }
+        return id;
+    };
+
+    return {
+        intern: intern,
+        // Writes the n int32 at pid, no allocation happens on the wasm heap.
+        internArray: function(arr, pid, n) {
+            for (let i = 0; i < n; ++i) {
+                HEAP32[(pid >> 2) + i] = intern(arr[i]);
+            }
+        },
+        find: function(str) {
+            const id = mapstrid.get(str);
+            return id === undefined ? -1 : id;
+        },
+        lookup: function(id) {
+            return vecstr[id];
+        },
+        lookupArray: function(pid, n) {
+            const arr = new Array(n);
+            for (let i = 0; i < n; ++i) {
+                arr[i] = vecstr[HEAP32[(pid >> 2) + i]];
+            }
+            return arr;
+        },
+        size: function() {
+            return vecstr.length;
+        }
+    };
+}
+
+// Identity IDs of JS objects and functions, see tc::jst::js_identity_id. The WeakMap does not keep the objects alive,
+// and IDs are never reused, so an ID stays unique even after its object has been collected.
+Module.tc_js_intern_detail_js_mapobjid = new WeakMap();
+Module.tc_js_intern_detail_js_idNext = 1;
+
+Module.tc_js_intern_detail_js_IdentityId = function(obj) {
+    // Throws a TypeError for primitives, which have no identity.
+    const mapobjid = Module.tc_js_intern_detail_js_mapobjid;
+    let id = mapobjid.get(obj);
+    if (id === undefined) {
+        id = Module.tc_js_intern_detail_js_idNext++;
+        mapobjid.set(obj, id);
+    }
+    return id;
+}
+
+Module.tc_js_intern_detail_js_IdentityIds = function(arr, pid, n) {
+    // Writes the IDs of the first n array elements as doubles at pid. IDs stay below 2^53.
+    for (let i = 0; i < n; ++i) {
+        HEAPF64[(pid >> 3) + i] = Module.tc_js_intern_detail_js_IdentityId(arr[i]);
+    }
+}
@@ -0,0 +1,30 @@
+Module.tc_js_log_detail_js_ScheduleMicrotask = function(fn) {
+    // The logger may have been destroyed (and flushed) before the microtask runs.
+    const fnFlush = function() {
+        if (!fn.isDetached()) {
+            fn();
+        }
+    };
+    if (typeof queueMicrotask === 'function') {
+        queueMicrotask(fnFlush);
+    } else {
+        Promise.resolve().then(fnFlush);
+    }
+}
+
+Module.tc_js_log_detail_js_Flush = function(viewnLevel, viewnOffset, viewch) {
+    // Order of levels has to match tc::jst::EConsoleLevel.
+    const astrMethod = ['log', 'error', 'warn', 'debug'];
+    // Consecutive lines of the same level are passed to the console in a single call.
+    let iBegin = 0;
+    while (iBegin < viewnLevel.length) {
+        let iEnd = iBegin + 1;
+        while (iEnd < viewnLevel.length && viewnLevel[iEnd] === viewnLevel[iBegin]) {
+            ++iEnd;
+        }
+        console[astrMethod[viewnLevel[iBegin]]](
+            UTF8ArrayToString(viewch, viewnOffset[iBegin], viewnOffset[iEnd] - viewnOffset[iBegin] - 1)
+        );
+        iBegin = iEnd;
+    }
+}
@@ -0,0 +1,130 @@
+#include "js_marshal_detail.h"
+#include <emscripten/bind.h>
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace tc::jst {
+namespace marshal_detail {
+void EnsureJsMarshalCppIsLinked() {}
+
+// Called from JS to allocate buffers which are returned to and owned by C++.
+// See comments in js_callback.cpp about passing pointers as numbers.
+static_assert(sizeof(void*) <= sizeof(PointerNumber));
+
+PointerNumber Allocate(std::size_t cb) noexcept {
+	void* const p = std::malloc(cb);
+	_ASSERT(p);
+	return reinterpret_cast<PointerNumber>(p);
+}
+
+namespace {
+// Read and written by tc_js_marshal_detail_js_ArenaAllocate as two uint32 at ArenaState(), so the layout must not change.
+struct SArenaState final {
+	std::uint32_t m_nCur;
+	std::uint32_t m_nEnd;
+};
+static_assert(sizeof(SArenaState) == 2 * sizeof(std::uint32_t));
+
+constexpr std::size_t c_cbArenaBlockMin = 64 * 1024;
+constexpr std::size_t c_cbArenaRetainMax = 1024 * 1024; // Total size of the blocks kept when the outermost CArenaScope ends
+
+struct SArenaBlock final {
+	std::unique_ptr<std::byte[]> m_pby;
+	std::size_t m_cb;
+};
+
+// One arena per thread. With -pthread, every worker runs its own copy of js_marshal.js, which caches the address of its thread's state.
+thread_local SArenaState g_arenastate{0, 0};
+thread_local std::vector<SArenaBlock> g_vecarenablock;
+thread_local std::size_t g_iArenaBlock = 0; // Current block, valid if !g_vecarenablock.empty()
+thread_local int g_nArenaScopes = 0;
+
+std::uint32_t BlockBegin(std::size_t iBlock) noexcept {
+	return static_cast<std::uint32_t>(reinterpret_cast<PointerNumber>(g_vecarenablock[iBlock].m_pby.get()));
+}
+
+void SetCurrentBlock(std::size_t iBlock, std::uint32_t nCur) noexcept {
+	g_iArenaBlock = iBlock;
+	g_arenastate.m_nCur = nCur;
+	g_arenastate.m_nEnd = static_cast<std::uint32_t>(BlockBegin(iBlock) + g_vecarenablock[iBlock].m_cb);
+}
+
+std::uint32_t AlignUp(std::uint32_t n, std::size_t nAlign) noexcept {
+	return static_cast<std::uint32_t>((n + nAlign - 1) / nAlign * nAlign);
+}
+} // namespace
+
+PointerNumber ArenaAllocate(std::size_t cb, std::size_t nAlign) noexcept {
+	_ASSERT(0 < g_nArenaScopes && "Arena memory must be allocated within a CArenaScope");
+	if(!g_vecarenablock.empty()) {
+		std::uint32_t const nBegin = AlignUp(g_arenastate.m_nCur, nAlign);
+		if(nBegin + cb <= g_arenastate.m_nEnd) {
+			g_arenastate.m_nCur = static_cast<std::uint32_t>(nBegin + cb);
+			return nBegin;
+		}
+	}
+	// Blocks after the current one are unused. Reuse the next one if it is large enough, otherwise replace it.
+	std::size_t const cbBlock = std::max({c_cbArenaBlockMin, cb + nAlign, g_vecarenablock.empty() ? 0 : 2 * g_vecarenablock[g_iArenaBlock].m_cb});
+	std::size_t const iBlock = g_vecarenablock.empty() ? 0 : g_iArenaBlock + 1;
+	if(g_vecarenablock.size() <= iBlock) {
+		g_vecarenablock.push_back(SArenaBlock{std::make_unique<std::byte[]>(cbBlock), cbBlock});
+	} else if(g_vecarenablock[iBlock].m_cb < cb + nAlign) {
+		g_vecarenablock[iBlock] = SArenaBlock{std::make_unique<std::byte[]>(cbBlock), cbBlock};
+	}
+	SetCurrentBlock(iBlock, BlockBegin(iBlock));
+	std::uint32_t const nBegin = AlignUp(g_arenastate.m_nCur, nAlign);
+	g_arenastate.m_nCur = static_cast<std::uint32_t>(nBegin + cb);
+	_ASSERT(g_arenastate.m_nCur <= g_arenastate.m_nEnd);
+	return nBegin;
+}
+
+namespace no_adl {
+CArenaScope::CArenaScope() noexcept : m_iBlock(g_iArenaBlock), m_nCur(g_arenastate.m_nCur) {
+	++g_nArenaScopes;
+}
+
+CArenaScope::~CArenaScope() {
+	--g_nArenaScopes;
+	if(!g_vecarenablock.empty()) {
+		if(0 == m_nCur) { // The scope started before the first block was allocated.
+			SetCurrentBlock(0, BlockBegin(0));
+		} else {
+			SetCurrentBlock(m_iBlock, m_nCur);
+		}
+		if(0 == g_nArenaScopes) {
+			// Free the blocks beyond c_cbArenaRetainMax, which only large transfers need. The current block is the first one.
+			_ASSERTEQUAL(g_iArenaBlock, 0u);
+			std::size_t cbRetained = 0;
+			g_vecarenablock.erase(
+				std::find_if(g_vecarenablock.begin(), g_vecarenablock.end(), [&](SArenaBlock const& arenablock) noexcept {
+					cbRetained += arenablock.m_cb;
+					return c_cbArenaRetainMax < cbRetained;
+				}),
+				g_vecarenablock.end()
+			);
+			if(g_vecarenablock.empty()) {
+				g_arenastate = SArenaState{0, 0};
+			}
+		}
+	}
+}
+} // namespace no_adl
+
+// Called from tc_js_marshal_detail_js_ArenaAllocate if the current block is full.
+PointerNumber ArenaAllocateFromJs(std::size_t cb) noexcept {
+	return ArenaAllocate(cb, 8);
+}
+
+PointerNumber ArenaState() noexcept {
+	return reinterpret_cast<PointerNumber>(&g_arenastate);
+}
+
+EMSCRIPTEN_BINDINGS(tc_js_marshal_detail_bind) {
+	emscripten::function("tc_js_marshal_detail_Allocate", &Allocate);
+	emscripten::function("tc_js_marshal_detail_ArenaAllocate", &ArenaAllocateFromJs);
+	emscripten::function("tc_js_marshal_detail_ArenaState", &ArenaState);
+}
+
+} // namespace marshal_detail
+} // namespace tc::jst
@@ -0,0 +1,512 @@
+// Buffers returned to C++ are allocated by tc_js_marshal_detail_Allocate (js_marshal.cpp) and owned by C++ afterwards,
+// or, for payloads C++ consumes within the call, by tc_js_marshal_detail_js_ArenaAllocate.
+// Allocating may grow the wasm memory, so HEAP* views must only be accessed after the allocation.
+
+Module.tc_js_marshal_detail_js_ArenaAllocate = function(cb) {
+    // Bump allocation in the arena of js_marshal.cpp, see tc::jst::marshal_detail::CArenaScope. The result is aligned to 8 bytes.
+    // Only calls into C++ if the current block of the arena is full.
+    if (undefined === Module.tc_js_marshal_detail_js_pArenaState) {
+        Module.tc_js_marshal_detail_js_pArenaState = Module.tc_js_marshal_detail_ArenaState();
+    }
+    const i32 = Module.tc_js_marshal_detail_js_pArenaState >> 2; // uint32 m_nCur, uint32 m_nEnd
+    const p = ((HEAPU32[i32] + 7) & ~7) >>> 0;
+    if (0 !== HEAPU32[i32 + 1] && p + cb <= HEAPU32[i32 + 1]) {
+        HEAPU32[i32] = p + cb;
+        return p;
+    }
+    return Module.tc_js_marshal_detail_ArenaAllocate(cb);
+}
+
+Module.tc_js_marshal_detail_js_EncodeStringArray = function(arr) {
+    // Layout: uint32 count, uint32 offsets[count + 1], UTF-8 characters without terminators.
+    const n = arr.length;
+    const veccb = new Array(n);
+    let cbString = 0;
+    for (let i = 0; i < n; ++i) {
+        veccb[i] = lengthBytesUTF8(arr[i]);
+        cbString += veccb[i];
+    }
+    const cbHeader = 4 * (n + 2);
+    // stringToUTF8Array always writes a terminator, reserve one byte for the last one.
+    const ptr = Module.tc_js_marshal_detail_Allocate(cbHeader + cbString + 1);
+    const i32 = ptr >> 2;
+    HEAPU32[i32] = n;
+    let ib = 0;
+    for (let i = 0; i < n; ++i) {
+        HEAPU32[i32 + 1 + i] = ib;
+        stringToUTF8Array(arr[i], HEAPU8, ptr + cbHeader + ib, veccb[i] + 1);
+        ib += veccb[i];
+    }
+    HEAPU32[i32 + 1 + n] = ib;
+    return ptr;
+}
+
+Module.tc_js_marshal_detail_js_DecodeStringArray = function(pnOffset, n, pch) {
+    // n strings of UTF-8 characters at pch, delimited by the n + 1 uint32 offsets at pnOffset. The last offset is the total byte length.
+    const i32 = pnOffset >> 2;
+    const arr = new Array(n);
+    for (let i = 0; i < n; ++i) {
+        arr[i] = UTF8ToString(pch + HEAPU32[i32 + i], HEAPU32[i32 + i + 1] - HEAPU32[i32 + i]);
+    }
+    return arr;
+}
+
+Module.tc_js_marshal_detail_js_Utf8ToString = function(pch, cb) {
+    // Keeps embedded zeros like the embind conversion of std::string, which UTF8ToString alone would stop at.
+    let str = '';
+    let iBegin = pch;
+    for (let i = pch; i < pch + cb; ++i) {
+        if (0 === HEAPU8[i]) {
+            str += UTF8ToString(iBegin, i - iBegin) + '\0';
+            iBegin = i + 1;
+        }
+    }
+    return str + UTF8ToString(iBegin, pch + cb - iBegin);
+}
+
+Module.tc_js_marshal_detail_js_ToJsonBuffer = function(value) {
+    // Layout: uint32 byte length, UTF-8 characters, terminating zero.
+    const str = JSON.stringify(value);
+    if (str === undefined) {
+        return 0; // e.g. undefined or a function
+    }
+    const cb = lengthBytesUTF8(str);
+    const ptr = Module.tc_js_marshal_detail_Allocate(4 + cb + 1);
+    HEAPU32[ptr >> 2] = cb;
+    stringToUTF8Array(str, HEAPU8, ptr + 4, cb + 1);
+    return ptr;
+}
+
+Module.tc_js_marshal_detail_js_FromJsonBuffer = function(pch, cb) {
+    return JSON.parse(UTF8ToString(pch, cb));
+}
+
+Module.tc_js_marshal_detail_js_ToHandle = function(value) {
+    // The handle is owned by C++, see marshal_detail::TakeHandle. Emval.toHandle replaced __emval_register in newer emscripten versions.
+    return typeof Emval !== 'undefined' ? Emval.toHandle(value) : __emval_register(value);
+}
+
+Module.tc_js_marshal_detail_js_ReadNumbers = function(arr, iBegin, pdbl, nMax) {
+    // Returns the number of elements written to the nMax doubles at pdbl. Booleans are stored as 0/1.
+    // Passing a pointer instead of a typed array spares creating a typed array per call.
+    const n = Math.max(0, Math.min(nMax, arr.length - iBegin));
+    const i64 = pdbl >> 3;
+    for (let i = 0; i < n; ++i) {
+        HEAPF64[i64 + i] = arr[iBegin + i];
+    }
+    return n;
+}
+
+Module.tc_js_marshal_detail_js_ReadHandles = function(arr, iBegin, ph, nMax) {
+    // Returns the number of elements written to the nMax uint32 at ph. Creating handles does not allocate wasm memory.
+    const n = Math.max(0, Math.min(nMax, arr.length - iBegin));
+    const i32 = ph >> 2;
+    for (let i = 0; i < n; ++i) {
+        HEAPU32[i32 + i] = Module.tc_js_marshal_detail_js_ToHandle(arr[iBegin + i]);
+    }
+    return n;
+}
+
+Module.tc_js_marshal_detail_js_FromHandle = function(h) {
+    // The handle stays owned by C++.
+    return typeof Emval !== 'undefined' ? Emval.toValue(h) : requireHandle(h);
+}
+
+Module.tc_js_marshal_detail_js_TakeHandle = function(h) {
+    // Takes ownership of a handle passed by marshal_detail::ReleaseHandle.
+    const value = Module.tc_js_marshal_detail_js_FromHandle(h);
+    __emval_decref(h);
+    return value;
+}
+
+Module.tc_js_marshal_detail_js_Splice = function(arr, iStart, nDelete, items) {
+    // Like arr.splice(iStart, nDelete, ...items) without the argument count limit of spread arguments.
+    iStart = Math.max(0, Math.min(iStart, arr.length));
+    nDelete = Math.max(0, Math.min(nDelete, arr.length - iStart));
+    const tail = arr.slice(iStart + nDelete);
+    arr.length = iStart;
+    for (let i = 0; i < items.length; ++i) {
+        arr.push(items[i]);
+    }
+    for (let i = 0; i < tail.length; ++i) {
+        arr.push(tail[i]);
+    }
+}
+
+Module.tc_js_marshal_detail_js_SpliceNumbers = function(arr, iStart, nDelete, pdbl, n, bBoolean) {
+    Module.tc_js_marshal_detail_js_Splice(arr, iStart, nDelete, Module.tc_js_marshal_detail_js_DecodeArray(bBoolean ? 1 : 0, pdbl, n, 0));
+}
+
+Module.tc_js_marshal_detail_js_SpliceHandles = function(arr, iStart, nDelete, ph, n) {
+    // Takes ownership of the handles.
+    Module.tc_js_marshal_detail_js_Splice(arr, iStart, nDelete, Module.tc_js_marshal_detail_js_DecodeArray(2, ph, n, 0));
+}
+
+Module.tc_js_marshal_detail_js_CopyTypedArrayTo = function(ta, view) {
+    // Returns the number of elements written to view.
+    const n = Math.min(ta.length, view.length);
+    view.set(n === ta.length ? ta : ta.subarray(0, n));
+    return n;
+}
+
+Module.tc_js_marshal_detail_js_CopyTypedArrayFrom = function(ta, view, iOffset) {
+    ta.set(view, iOffset);
+}
+
+Module.tc_js_marshal_detail_js_CopyTypedArrayNew = function(view) {
+    // slice copies into a new buffer of the same typed array type, so the result does not depend on wasm memory.
+    return view.slice();
+}
+
+Module.tc_js_marshal_detail_js_GetIterator = function(iterable) {
+    return iterable[Symbol.iterator]();
+}
+
+Module.tc_js_marshal_detail_js_GetAsyncIterator = function(iterable) {
+    return iterable[Symbol.asyncIterator]();
+}
+
+// Unlike for...of, the Read*Iterator functions do not close the iterator when the buffer is full, so reading can continue later.
+// The iterator may run arbitrary JS code which grows the wasm memory, so HEAP* are looked up again for every element.
+Module.tc_js_marshal_detail_js_ReadIteratorNumbers = function(it, pdbl, nMax) {
+    // Returns the number of elements written to the nMax doubles at pdbl, less than nMax when the iterator is done. Booleans are stored as 0/1.
+    const i64 = pdbl >> 3;
+    let n = 0;
+    while (n < nMax) {
+        const result = it.next();
+        if (result.done) {
+            break;
+        }
+        HEAPF64[i64 + n++] = result.value;
+    }
+    return n;
+}
+
+Module.tc_js_marshal_detail_js_ReadIteratorHandles = function(it, ph, nMax) {
+    const i32 = ph >> 2;
+    let n = 0;
+    while (n < nMax) {
+        const result = it.next();
+        if (result.done) {
+            break;
+        }
+        HEAPU32[i32 + n++] = Module.tc_js_marshal_detail_js_ToHandle(result.value);
+    }
+    return n;
+}
+
+Module.tc_js_marshal_detail_js_ReadMapEntries = function(map, bKeyNumbers, bValueNumbers) {
+    // Copies all entries of map into the arena in a single pass, see tc::jst::range_detail::ReadMapEntries.
+    // Layout: uint32 count, padding, 8 byte slots for the keys, then 8 byte slots for the values.
+    // A slot holds a double if the respective flag is set, booleans as 0/1, and otherwise a handle in its first 4 bytes.
+    const n = map.size;
+    const ptr = Module.tc_js_marshal_detail_js_ArenaAllocate(8 + 16 * n);
+    HEAPU32[ptr >> 2] = n;
+    const iKey = (ptr >> 3) + 1;
+    const iValue = iKey + n;
+    let i = 0;
+    map.forEach(function(value, key) {
+        if (bKeyNumbers) {
+            HEAPF64[iKey + i] = key;
+        } else {
+            HEAPU32[(iKey + i) * 2] = Module.tc_js_marshal_detail_js_ToHandle(key);
+        }
+        if (bValueNumbers) {
+            HEAPF64[iValue + i] = value;
+        } else {
+            HEAPU32[(iValue + i) * 2] = Module.tc_js_marshal_detail_js_ToHandle(value);
+        }
+        ++i;
+    });
+    return ptr;
+}
+
+Module.tc_js_marshal_detail_js_ReadAsyncIterator = function(it, n) {
+    // Resolves to an array of at most n elements, shorter when the iterator is done. Does not request more elements than that.
+    const arr = [];
+    function step() {
+        if (arr.length >= n) {
+            return arr;
+        }
+        return Promise.resolve(it.next()).then(function(result) {
+            if (result.done) {
+                return arr;
+            }
+            arr.push(result.value);
+            return step();
+        });
+    }
+    return Promise.resolve(step());
+}
+
+Module.tc_js_marshal_detail_js_EncodeNumbers = function(arr) {
+    // Layout: uint32 count, 4 bytes padding, float64 values[count]. Booleans are stored as 0/1, strings are converted by Number().
+    // Allocated in the arena, so C++ must read it within its CArenaScope.
+    const n = arr.length;
+    const ptr = Module.tc_js_marshal_detail_js_ArenaAllocate(8 + 8 * n);
+    HEAPU32[ptr >> 2] = n;
+    HEAPF64.set(arr, (ptr >> 3) + 1);
+    return ptr;
+}
+
+Module.tc_js_marshal_detail_js_EncodeHandles = function(arr) {
+    // Layout: uint32 count, uint32 handles[count]. The handles are owned by C++. Allocated in the arena like EncodeNumbers.
+    const n = arr.length;
+    const ptr = Module.tc_js_marshal_detail_js_ArenaAllocate(4 + 4 * n);
+    const i32 = ptr >> 2;
+    HEAPU32[i32] = n;
+    for (let i = 0; i < n; ++i) {
+        HEAPU32[i32 + 1 + i] = Module.tc_js_marshal_detail_js_ToHandle(arr[i]);
+    }
+    return ptr;
+}
+
+Module.tc_js_marshal_detail_js_EncodeRecord = function(rec, bValues, bHandles) {
+    // Keys and values in the order of Object.keys.
+    const keys = Object.keys(rec);
+    const arr = bValues ? keys.map(key => rec[key]) : keys;
+    return bHandles ? Module.tc_js_marshal_detail_js_EncodeHandles(arr) : Module.tc_js_marshal_detail_js_EncodeNumbers(arr);
+}
+
+Module.tc_js_marshal_detail_js_DecodeArray = function(iEncoding, p, n, pch) {
+    // See tc::jst::range_detail::EArrayEncoding and CEncodedArray. p points to n doubles, n handles owned by JS,
+    // or n + 1 UTF-8 offsets into the characters at pch.
+    const arr = new Array(n);
+    switch (iEncoding) {
+        case 0:
+            for (let i = 0; i < n; ++i) {
+                arr[i] = HEAPF64[(p >> 3) + i];
+            }
+            return arr;
+        case 1:
+            for (let i = 0; i < n; ++i) {
+                arr[i] = HEAPF64[(p >> 3) + i] !== 0;
+            }
+            return arr;
+        case 2:
+            for (let i = 0; i < n; ++i) {
+                arr[i] = Module.tc_js_marshal_detail_js_TakeHandle(HEAPU32[(p >> 2) + i]);
+            }
+            return arr;
+        case 3: return Module.tc_js_marshal_detail_js_DecodeStringArray(p, n, pch);
+    }
+    throw new Error('Unknown array encoding ' + iEncoding);
+}
+
+Module.tc_js_marshal_detail_js_CreateRecord = function(n, iEncodingKey, pKey, pchKey, iEncodingValue, pValue) {
+    const keys = Module.tc_js_marshal_detail_js_DecodeArray(iEncodingKey, pKey, n, pchKey);
+    const values = Module.tc_js_marshal_detail_js_DecodeArray(iEncodingValue, pValue, n, 0);
+    const rec = {};
+    for (let i = 0; i < keys.length; ++i) {
+        rec[keys[i]] = values[i];
+    }
+    return rec;
+}
+
+Module.tc_js_marshal_detail_js_EncodeRecordKeysUtf8 = function(rec) {
+    return Module.tc_js_marshal_detail_js_EncodeStringArray(Object.keys(rec));
+}
+
+Module.tc_js_marshal_detail_js_CreateStructAccessor = function(arrstrName, viewiEncoding) {
+    // Compiles read(obj, pdbl, ph) and write(obj, pdbl, ph) for a fixed list of properties, see tc::jst::property_detail::CStructAccessor.
+    // Numbers and booleans are stored in the doubles at pdbl, other values as handles at ph, both in the order of arrstrName.
+    // read creates handles owned by C++, write takes ownership of the handles.
+    // The encodings are those of tc::jst::range_detail::EArrayEncoding, only number, boolean and handle are allowed.
+    let strRead = '';
+    let strWrite = '';
+    let iNumber = 0;
+    let iHandle = 0;
+    for (let i = 0; i < arrstrName.length; ++i) {
+        const strProperty = 'obj[' + JSON.stringify(arrstrName[i]) + ']';
+        switch (viewiEncoding[i]) {
+            case 0:
+                strRead += 'heapf64[i64 + ' + iNumber + '] = ' + strProperty + ';\n';
+                strWrite += strProperty + ' = heapf64[i64 + ' + iNumber + '];\n';
+                ++iNumber;
+                break;
+            case 1:
+                strRead += 'heapf64[i64 + ' + iNumber + '] = ' + strProperty + ' ? 1 : 0;\n';
+                strWrite += strProperty + ' = heapf64[i64 + ' + iNumber + '] !== 0;\n';
+                ++iNumber;
+                break;
+            case 2:
+                strRead += 'heapu32[i32 + ' + iHandle + '] = toHandle(' + strProperty + ');\n';
+                strWrite += strProperty + ' = takeHandle(heapu32[i32 + ' + iHandle + ']);\n';
+                ++iHandle;
+                break;
+            default:
+                throw new Error('Unsupported property encoding ' + viewiEncoding[i]);
+        }
+    }
+    // The HEAP* views are replaced when the wasm memory grows, so they are passed on every call.
+    const accessor = new Function('toHandle', 'takeHandle',
+        'return {\n' +
+        'read: function(obj, heapf64, i64, heapu32, i32) {\n' + strRead + '},\n' +
+        'write: function(obj, heapf64, i64, heapu32, i32) {\n' + strWrite + '}\n' +
+        '};'
+    )(Module.tc_js_marshal_detail_js_ToHandle, Module.tc_js_marshal_detail_js_TakeHandle);
+    return {
+        read: function(obj, pdbl, ph) { accessor.read(obj, HEAPF64, pdbl >> 3, HEAPU32, ph >> 2); },
+        write: function(obj, pdbl, ph) { accessor.write(obj, HEAPF64, pdbl >> 3, HEAPU32, ph >> 2); }
+    };
+}
+
+Module.tc_js_marshal_detail_js_CreateObjectFactory = function(arrstrName, viewiEncoding) {
+    // Compiles create(pbSet, pdbl, ph) returning an object literal, see tc::jst::property_detail::CObjectFactory.
+    // Only properties whose byte at pbSet is not 0 are created, their values are stored at pdbl and ph like for CreateStructAccessor.
+    let strCreate = 'const obj = {};\nlet iNumber = i64;\nlet iHandle = i32;\n';
+    for (let i = 0; i < arrstrName.length; ++i) {
+        const strProperty = 'obj[' + JSON.stringify(arrstrName[i]) + ']';
+        switch (viewiEncoding[i]) {
+            case 0: strCreate += 'if (heapu8[pbSet + ' + i + ']) ' + strProperty + ' = heapf64[iNumber++];\n'; break;
+            case 1: strCreate += 'if (heapu8[pbSet + ' + i + ']) ' + strProperty + ' = heapf64[iNumber++] !== 0;\n'; break;
+            case 2: strCreate += 'if (heapu8[pbSet + ' + i + ']) ' + strProperty + ' = takeHandle(heapu32[iHandle++]);\n'; break;
+            default: throw new Error('Unsupported property encoding ' + viewiEncoding[i]);
+        }
+    }
+    strCreate += 'return obj;\n';
+    const create = new Function('takeHandle',
+        'return function(heapu8, pbSet, heapf64, i64, heapu32, i32) {\n' + strCreate + '};'
+    )(Module.tc_js_marshal_detail_js_TakeHandle);
+    return function(pbSet, pdbl, ph) {
+        return create(HEAPU8, pbSet, HEAPF64, pdbl >> 3, HEAPU32, ph >> 2);
+    };
+}
+
+Module.tc_js_marshal_detail_js_CreateStructDecoder = function(arrstrName, viewiEncoding) {
+    // Decoders for structs packed by tc::jst::struct_detail::CPackedStructs. The encodings are those of tc::jst::range_detail::EArrayEncoding.
+    // Fields are stored row by row: numbers and booleans as doubles at pdbl, handles owned by JS at ph and strings as UTF-8 at pch,
+    // delimited by the uint32 offsets at pnOffset, which have one more element than there are strings.
+    const aiEncoding = Array.from(viewiEncoding); // the view is only valid during this call
+    const nFields = arrstrName.length;
+    const aiIndex = new Array(nFields); // index of the field within the values of its encoding of one row
+    const anPerRow = [0, 0, 0]; // numbers, handles, strings
+    const aiSlot = [0, 0, 1, 2]; // slot in anPerRow by encoding, booleans are numbers
+    for (let i = 0; i < nFields; ++i) {
+        if (aiEncoding[i] < 0 || 3 < aiEncoding[i]) {
+            throw new Error('Unsupported field encoding ' + aiEncoding[i]);
+        }
+        aiIndex[i] = anPerRow[aiSlot[aiEncoding[i]]]++;
+    }
+    const [nNumbers, nHandles, nStrings] = anPerRow;
+
+    function Value(iEncoding, iIndex, iRow, pdbl, ph, pnOffset, pch) {
+        switch (iEncoding) {
+            case 0: return HEAPF64[(pdbl >> 3) + iRow * nNumbers + iIndex];
+            case 1: return HEAPF64[(pdbl >> 3) + iRow * nNumbers + iIndex] !== 0;
+            case 2: return Module.tc_js_marshal_detail_js_TakeHandle(HEAPU32[(ph >> 2) + iRow * nHandles + iIndex]);
+            case 3: {
+                const iString = (pnOffset >> 2) + iRow * nStrings + iIndex;
+                return UTF8ArrayToString(HEAPU8, pch + HEAPU32[iString], HEAPU32[iString + 1] - HEAPU32[iString]);
+            }
+        }
+    }
+
+    // The objects are created by a single object literal, so all of them share the same shape.
+    // The HEAP* views are replaced when the wasm memory grows, so they are passed on every call.
+    const strObject = '{\n' + arrstrName.map(function(strName, i) {
+        const iIndex = aiIndex[i];
+        switch (aiEncoding[i]) {
+            case 0: return JSON.stringify(strName) + ': heapf64[iNumber + ' + iIndex + ']';
+            case 1: return JSON.stringify(strName) + ': heapf64[iNumber + ' + iIndex + '] !== 0';
+            case 2: return JSON.stringify(strName) + ': takeHandle(heapu32[iHandle + ' + iIndex + '])';
+            case 3: return JSON.stringify(strName) + ': utf8ToString(heapu8, pch + heapu32[iString + ' + iIndex + '], heapu32[iString + ' + (iIndex + 1) + '] - heapu32[iString + ' + iIndex + '])';
+        }
+    }).join(',\n') + '\n}';
+    const rowsCompiled = new Function('takeHandle', 'utf8ToString',
+        'return function(n, heapf64, i64, heapu32, i32Handle, i32Offset, heapu8, pch) {\n' +
+        'const arr = new Array(n);\n' +
+        'for (let i = 0; i < n; ++i) {\n' +
+        'const iNumber = i64 + i * ' + nNumbers + ';\n' +
+        'const iHandle = i32Handle + i * ' + nHandles + ';\n' +
+        'const iString = i32Offset + i * ' + nStrings + ';\n' +
+        'arr[i] = ' + strObject + ';\n' +
+        '}\n' +
+        'return arr;\n' +
+        '};'
+    )(Module.tc_js_marshal_detail_js_TakeHandle, UTF8ArrayToString);
+
+    function rows(n, pdbl, ph, pnOffset, pch) {
+        return rowsCompiled(n, HEAPF64, pdbl >> 3, HEAPU32, ph >> 2, pnOffset >> 2, HEAPU8, pch);
+    }
+
+    function columns(n, pdbl, ph, pnOffset, pch) {
+        const obj = {};
+        for (let i = 0; i < nFields; ++i) {
+            const iEncoding = aiEncoding[i];
+            const col = 0 === iEncoding ? new Float64Array(n) : new Array(n);
+            for (let iRow = 0; iRow < n; ++iRow) {
+                col[iRow] = Value(iEncoding, aiIndex[i], iRow, pdbl, ph, pnOffset, pch);
+            }
+            obj[arrstrName[i]] = col;
+        }
+        return obj;
+    }
+
+    return { rows: rows, columns: columns };
+}
+
+Module.tc_js_marshal_detail_js_symStructViewPointer = Symbol('tcjs struct view pointer');
+
+Module.tc_js_marshal_detail_js_CreateStructViewClass = function(arrstrName, viewiKind, viewnOffset) {
+    // Class of views whose properties read and write fields of a C++ struct in wasm memory, see tc::jst::js_struct_view.
+    // The kinds are those of tc::jst::struct_detail::EViewField. HEAP* are looked up on every access
+    // because growing the wasm memory replaces them.
+    const sym = Module.tc_js_marshal_detail_js_symStructViewPointer;
+    function View(p) {
+        this[sym] = p;
+    }
+    function Address(view, nOffset) {
+        const p = view[sym];
+        if (0 === p) {
+            throw new Error('The C++ struct of this view has been destroyed');
+        }
+        return p + nOffset;
+    }
+    for (let i = 0; i < arrstrName.length; ++i) {
+        const nOffset = viewnOffset[i];
+        let get, set;
+        switch (viewiKind[i]) {
+            case 1: get = function() { return HEAPF64[Address(this, nOffset) >> 3]; }; set = function(value) { HEAPF64[Address(this, nOffset) >> 3] = value; }; break;
+            case 2: get = function() { return HEAPF32[Address(this, nOffset) >> 2]; }; set = function(value) { HEAPF32[Address(this, nOffset) >> 2] = value; }; break;
+            case 3: get = function() { return HEAP32[Address(this, nOffset) >> 2]; }; set = function(value) { HEAP32[Address(this, nOffset) >> 2] = value; }; break;
+            case 4: get = function() { return HEAPU32[Address(this, nOffset) >> 2]; }; set = function(value) { HEAPU32[Address(this, nOffset) >> 2] = value; }; break;
+            case 5: get = function() { return HEAP16[Address(this, nOffset) >> 1]; }; set = function(value) { HEAP16[Address(this, nOffset) >> 1] = value; }; break;
+            case 6: get = function() { return HEAPU16[Address(this, nOffset) >> 1]; }; set = function(value) { HEAPU16[Address(this, nOffset) >> 1] = value; }; break;
+            case 7: get = function() { return HEAP8[Address(this, nOffset)]; }; set = function(value) { HEAP8[Address(this, nOffset)] = value; }; break;
+            case 8: get = function() { return HEAPU8[Address(this, nOffset)]; }; set = function(value) { HEAPU8[Address(this, nOffset)] = value; }; break;
+            case 9: get = function() { return HEAPU8[Address(this, nOffset)] !== 0; }; set = function(value) { HEAPU8[Address(this, nOffset)] = value ? 1 : 0; }; break;
+            default: throw new Error('Unsupported struct view field ' + viewiKind[i]);
+        }
+        Object.defineProperty(View.prototype, arrstrName[i], { get: get, set: set, enumerable: true });
+    }
+    return View;
+}
+
+Module.tc_js_marshal_detail_js_DetachStructView = function(view) {
+    view[Module.tc_js_marshal_detail_js_symStructViewPointer] = 0;
+}
+
+Module.tc_js_marshal_detail_js_CompilePath = function(arrstrName, viewnArgs, viewbOptional) {
+    // Compiles function(obj, ...args) evaluating a chain of property accesses and method calls, see tc::jst::js_path.
+    // viewnArgs[i] < 0 accesses the property arrstrName[i], otherwise the method arrstrName[i] is called with that many arguments.
+    // If viewbOptional[i] is set, the chain evaluates to undefined if the value before step i is undefined or null.
+    const arrstrParam = ['obj'];
+    let strBody = 'let v = obj;\n';
+    for (let i = 0; i < arrstrName.length; ++i) {
+        if (viewbOptional[i]) {
+            strBody += 'if (null == v) return undefined;\n';
+        }
+        strBody += 'v = v[' + JSON.stringify(arrstrName[i]) + ']';
+        if (0 <= viewnArgs[i]) {
+            const arrstrArg = [];
+            for (let iArg = 0; iArg < viewnArgs[i]; ++iArg) {
+                arrstrArg.push('a' + (arrstrParam.length - 1));
+                arrstrParam.push(arrstrArg[arrstrArg.length - 1]);
+            }
+            strBody += '(' + arrstrArg.join(', ') + ')'; // Calls through a member expression, so this is bound.
+        }
+        strBody += ';\n';
+    }
+    return new Function(...arrstrParam, strBody + 'return v;');
+}
@@ -0,0 +1,122 @@
+// JS side of tc::jst::js_stream_reader and tc::jst::js_stream_writer (js_stream.h).
+// Chunks are copied between JS and wasm memory as bytes, strings are only converted in JS when a stream yields them.
+
+Module.tc_js_stream_detail_js_CreateReader = function(stream) {
+    // WHATWG ReadableStream, otherwise an async iterable such as a node Readable. Both only pull from the source
+    // when read is called, node pauses the Readable while its buffer is above the highWaterMark.
+    let next, cancel;
+    if (typeof stream.getReader === 'function') {
+        const reader = stream.getReader();
+        next = function() { return reader.read(); };
+        cancel = function() { return reader.cancel(); };
+    } else {
+        const it = stream[Symbol.asyncIterator]();
+        next = function() { return it.next(); };
+        cancel = function() { return typeof it.return === 'function' ? it.return() : undefined; };
+    }
+
+    let chunk = null; // Uint8Array, the rest of the current chunk which did not fit into the last buffer
+    let bDone = false;
+
+    function toBytes(value) {
+        if (typeof value === 'string') {
+            return new TextEncoder().encode(value);
+        } else if (ArrayBuffer.isView(value)) {
+            return new Uint8Array(value.buffer, value.byteOffset, value.byteLength);
+        } else {
+            return new Uint8Array(value);
+        }
+    }
+
+    function copy(p, cb) {
+        const n = Math.min(cb, chunk.length);
+        HEAPU8.set(n === chunk.length ? chunk : chunk.subarray(0, n), p);
+        chunk = n === chunk.length ? null : chunk.subarray(n);
+        return n;
+    }
+
+    function pull(p, cb) {
+        return next().then(function(result) {
+            if (result.done) {
+                bDone = true;
+                return 0;
+            }
+            chunk = toBytes(result.value);
+            if (0 === chunk.length) {
+                chunk = null;
+                return pull(p, cb);
+            }
+            return copy(p, cb); // HEAPU8 is looked up after awaiting, memory may have grown meanwhile.
+        });
+    }
+
+    return {
+        // Resolves to the number of bytes copied to the cb bytes at p, which is 0 only at the end of the stream.
+        read: function(p, cb) {
+            if (null !== chunk) {
+                return Promise.resolve(copy(p, cb));
+            } else if (bDone) {
+                return Promise.resolve(0);
+            } else {
+                return pull(p, cb);
+            }
+        },
+        cancel: function() {
+            chunk = null;
+            bDone = true;
+            return Promise.resolve(cancel());
+        }
+    };
+}
+
+Module.tc_js_stream_detail_js_CreateWriter = function(stream) {
+    // The bytes are copied before write returns, so C++ may reuse its buffer immediately.
+    // The Promise returned by write resolves when the stream accepts more data.
+    if (typeof stream.getWriter === 'function') {
+        // WHATWG WritableStream. A failed write also rejects writer.ready and writer.close.
+        const writer = stream.getWriter();
+        return {
+            write: function(p, cb) {
+                writer.write(HEAPU8.slice(p, p + cb)).catch(function() {});
+                return writer.ready;
+            },
+            end: function() {
+                return writer.close();
+            }
+        };
+    } else {
+        // node Writable
+        let error = null;
+        stream.on('error', function(e) { error = e; });
+        return {
+            write: function(p, cb) {
+                if (null !== error) {
+                    return Promise.reject(error);
+                } else if (stream.write(HEAPU8.slice(p, p + cb))) {
+                    return Promise.resolve();
+                }
+                return new Promise(function(resolve, reject) {
+                    function onDrain() {
+                        stream.off('error', onError);
+                        resolve();
+                    }
+                    function onError(e) {
+                        stream.off('drain', onDrain);
+                        reject(e);
+                    }
+                    stream.once('drain', onDrain);
+                    stream.once('error', onError);
+                });
+            },
+            end: function() {
+                if (null !== error) {
+                    return Promise.reject(error);
+                }
+                return new Promise(function(resolve, reject) {
+                    stream.once('error', reject);
+                    stream.end(function(e) { e ? reject(e) : resolve(); }); // Newer node versions pass errors to the callback.
+                });
+            }
+        };
+    }
+}
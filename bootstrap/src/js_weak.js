@@ -0,0 +1,51 @@
+// JS side of tc::jst::js_weak_cache (js_weak.h).
+
+Module.tc_js_weak_detail_js_CreateWeakCache = function(pnPending) {
+    // IDs of keys which have been collected, but not yet taken by C++. Their number is mirrored to the uint32 at pnPending,
+    // so C++ can check for them without calling into JS.
+    const arrid = [];
+    let bDisposed = false;
+    const registry = new FinalizationRegistry(function(id) {
+        if (!bDisposed) {
+            arrid.push(id);
+            HEAPU32[pnPending >> 2] = arrid.length;
+        }
+    });
+
+    return {
+        register: function(obj, id) {
+            // obj is also the unregister token, tokens are held weakly.
+            registry.register(obj, id, obj);
+        },
+        unregister: function(obj) {
+            registry.unregister(obj);
+        },
+        // Moves the first n collected IDs into the doubles at pid.
+        take: function(pid, n) {
+            for (let i = 0; i < n; ++i) {
+                HEAPF64[(pid >> 3) + i] = arrid[i];
+            }
+            arrid.splice(0, n);
+            HEAPU32[pnPending >> 2] = arrid.length;
+        },
+        // The C++ object is destroyed, pnPending must not be written anymore.
+        dispose: function() {
+            bDisposed = true;
+            arrid.length = 0;
+        }
+    };
+}
+
+Module.tc_js_weak_detail_js_CreateMemoizedGetter = function(name, bCall) {
+    // Getter of a memoized property or method without parameters, see tc::jst::property_detail::MemoizedProperty.
+    // The WeakMap holds each value only as long as its object is alive, even if the value refers back to the object.
+    const map = new WeakMap();
+    return function(obj) {
+        let value = map.get(obj);
+        if (undefined === value && !map.has(obj)) {
+            value = bCall ? obj[name]() : obj[name];
+            map.set(obj, value);
+        }
+        return value;
+    };
+}
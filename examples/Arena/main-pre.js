@@ -0,0 +1,25 @@
+Module.makeNumbers = function(n) {
+    const arr = new Array(n);
+    for (let i = 0; i < n; ++i) arr[i] = i;
+    return arr;
+}
+
+Module.allocateAcrossGrowth = function(cbLarge) {
+    // Allocating cbLarge grows the wasm memory, which replaces the buffer behind HEAPF64.
+    const p = Module.tc_js_marshal_detail_js_ArenaAllocate(8);
+    const heapf64Before = HEAPF64;
+    Module.tc_js_marshal_detail_js_ArenaAllocate(cbLarge);
+    if (heapf64Before === HEAPF64) throw new Error('Expected the allocation to grow the memory');
+    HEAPF64[p >> 3] = 0.5;
+    return p;
+}
+
+Module.allocateAroundCallback = function(callback) {
+    // The callback allocates in scopes of its own, which are released before it returns.
+    const p = Module.tc_js_marshal_detail_js_ArenaAllocate(8);
+    HEAPF64[p >> 3] = 1.5;
+    callback(Module.makeNumbers(100000));
+    const pNext = Module.tc_js_marshal_detail_js_ArenaAllocate(8);
+    HEAPF64[pNext >> 3] = 2.5;
+    return [p, pNext];
+}
@@ -0,0 +1,128 @@
+#include <emscripten/val.h>
+#include <cstdint>
+#include <iostream>
+#include <malloc.h>
+#include <numeric>
+#include <vector>
+#include "explicit_cast.h"
+#include "range.h"
+#include "range_defines.h"
+#include "js_types.h"
+#include "js_callback.h"
+#include "js_bootstrap.h"
+#include "js_marshal_detail.h"
+
+using tc::jst::create_js_object;
+using tc::jst::marshal_detail::ArenaSpan;
+using tc::jst::marshal_detail::CArenaScope;
+using tc::jst::marshal_detail::PointerNumber;
+
+namespace {
+	std::size_t AllocatedBytes() noexcept {
+		return mallinfo().uordblks;
+	}
+
+	// The uint32 m_nCur, m_nEnd shared with tc_js_marshal_detail_js_ArenaAllocate.
+	std::uint32_t const* ArenaState() noexcept {
+		return reinterpret_cast<std::uint32_t const*>(emscripten::val::module_property("tc_js_marshal_detail_ArenaState")().as<PointerNumber>());
+	}
+
+	void AssertIota(std::span<int> spann) noexcept {
+		for(int i = 0; i < tc::explicit_cast<int>(spann.size()); ++i) {
+			_ASSERTEQUAL(spann[i], i);
+		}
+	}
+}
+
+int main() {
+	std::size_t const cbLarge = 4 * 1024 * 1024; // More than js_marshal.cpp keeps when the outermost scope ends
+	{
+		std::cout << "===== Nested scopes\n";
+		std::size_t const cbAllocatedBefore = AllocatedBytes();
+		{
+			CArenaScope scopeOuter;
+			auto const spannOuter = ArenaSpan<int>(100);
+			std::iota(spannOuter.begin(), spannOuter.end(), 0);
+			int* pnInner;
+			{
+				CArenaScope scopeInner;
+				auto const spannInner = ArenaSpan<int>(100);
+				std::fill(spannInner.begin(), spannInner.end(), -1);
+				pnInner = spannInner.data();
+				_ASSERT(spannOuter.data() + spannOuter.size() <= pnInner);
+
+				// Does not fit into the current block, so the arena allocates another one.
+				auto const spanbyLarge = ArenaSpan<std::byte>(cbLarge);
+				std::fill(spanbyLarge.begin(), spanbyLarge.end(), std::byte{0xff});
+				_ASSERT(cbAllocatedBefore + cbLarge <= AllocatedBytes());
+			}
+			// The inner scope released its allocations, but not those of the outer scope.
+			AssertIota(spannOuter);
+			_ASSERTEQUAL(ArenaSpan<int>(100).data(), pnInner);
+		}
+		// The block holding the large allocation was freed when the outermost scope ended.
+		_ASSERT(AllocatedBytes() < cbAllocatedBefore + cbLarge);
+
+		// Smaller blocks are kept, so transferring the same amount again does not allocate.
+		{
+			CArenaScope scope;
+			ArenaSpan<std::byte>(256 * 1024);
+		}
+		std::size_t const cbAllocatedRetained = AllocatedBytes();
+		{
+			CArenaScope scope;
+			ArenaSpan<std::byte>(256 * 1024);
+			_ASSERTEQUAL(AllocatedBytes(), cbAllocatedRetained);
+		}
+		_ASSERTEQUAL(AllocatedBytes(), cbAllocatedRetained);
+	}
+	{
+		std::cout << "===== Growing the wasm memory\n";
+		std::vector<double> vecdbl(1000);
+		std::iota(vecdbl.begin(), vecdbl.end(), 0.0);
+		auto const AssertRoundTrip = [&]() noexcept {
+			tc::js::Array<double> jarrdbl(create_js_object, vecdbl);
+			_ASSERT(vecdbl == tc::make_vector(jarrdbl));
+			_ASSERTEQUAL(tc::explicit_cast<std::string>(tc::jst::js_string(std::string("arena"))), "arena");
+		};
+		// Compiles the JS decoders and caches the address of the arena state before the memory grows.
+		AssertRoundTrip();
+		{
+			CArenaScope scope;
+			double const* const pdbl = reinterpret_cast<double const*>(
+				emscripten::val::module_property("allocateAcrossGrowth")(64 * 1024 * 1024).as<PointerNumber>()
+			);
+			_ASSERTEQUAL(*pdbl, 0.5);
+		}
+		// JS reads the new HEAP* views, not those it used before.
+		AssertRoundTrip();
+	}
+	{
+		std::cout << "===== Allocating in a callback\n";
+		CArenaScope scope;
+		auto const spannOuter = ArenaSpan<int>(100);
+		std::iota(spannOuter.begin(), spannOuter.end(), 0);
+		int nCalls = 0;
+		auto const emvalp = emscripten::val::module_property("allocateAroundCallback")(tc::jst::js_lambda_wrap([&](tc::js::Array<double> jarrdbl) noexcept {
+			++nCalls;
+			// Allocates while the JS allocation of the caller is alive.
+			auto const vecdbl = tc::make_vector(jarrdbl);
+			_ASSERTEQUAL(tc::size(vecdbl), 100000);
+			_ASSERTEQUAL(tc::js::Array<double>(create_js_object, vecdbl)->length(), 100000);
+			CArenaScope scopeCallback;
+			ArenaSpan<std::byte>(cbLarge);
+		}));
+		_ASSERTEQUAL(nCalls, 1);
+		auto const pdbl = reinterpret_cast<double const*>(emvalp[0].as<PointerNumber>());
+		auto const pdblNext = reinterpret_cast<double const*>(emvalp[1].as<PointerNumber>());
+		// The callback released everything it allocated, so JS continued right after its first allocation.
+		_ASSERTEQUAL(pdblNext, pdbl + 1);
+		_ASSERTEQUAL(*pdbl, 1.5);
+		_ASSERTEQUAL(*pdblNext, 2.5);
+		_ASSERTEQUAL(ArenaState()[0], reinterpret_cast<PointerNumber>(pdblNext + 1));
+		AssertIota(spannOuter);
+	}
+
+	std::cout << "Success!\n";
+	return 0;
+}
@@ -0,0 +1,7 @@
+Module.assertEquals = function(got, expected) {
+   if (got !== expected) throw new Error('Got ' + got + ', expected ' + expected);
+}
+
+Module.checkArray = function(arr, expected) {
+    Module.assertEquals(JSON.stringify(arr), expected);
+}
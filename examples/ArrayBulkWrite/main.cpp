@@ -0,0 +1,60 @@
+#include <emscripten/val.h>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "explicit_cast.h"
+#include "range.h"
+#include "range_defines.h"
+#include "js_types.h"
+#include "js_bootstrap.h"
+
+using tc::jst::js_string;
+using tc::jst::js_unknown;
+
+namespace {
+	void CheckArray(tc::jst::js_unknown const& junkArray, char const* szExpected) noexcept {
+		emscripten::val::module_property("checkArray")(junkArray, js_string(szExpected));
+	}
+}
+
+int main() {
+	{
+		tc::js::Array<double> jarrdbl(tc::jst::create_js_object, std::vector<double>{1, 2, 3});
+		CheckArray(jarrdbl, "[1,2,3]");
+
+		jarrdbl->splice(1, 1, std::vector<double>{7, 8});
+		CheckArray(jarrdbl, "[1,7,8,3]");
+
+		jarrdbl->splice(4, 0, tc::iota(0, 2));
+		CheckArray(jarrdbl, "[1,7,8,3,0,1]");
+
+		jarrdbl->assign(std::vector<double>{});
+		_ASSERT(tc::empty(jarrdbl));
+
+		jarrdbl->assign(tc::iota(0, 10000));
+		_ASSERTEQUAL(jarrdbl->length(), 10000);
+		_ASSERTEQUAL(tc::accumulate(jarrdbl, 0.0, fn_assign_plus()), 10000 * 9999 / 2.0);
+	}
+	{
+		tc::js::Array<bool> jarrb(tc::jst::create_js_object, std::vector<bool>{true, false});
+		CheckArray(jarrb, "[true,false]");
+	}
+	{
+		tc::js::Array<js_string> jarrstr(tc::jst::create_js_object, std::vector<js_string>{js_string("foo"), js_string("bar")});
+		CheckArray(jarrstr, "[\"foo\",\"bar\"]");
+
+		jarrstr->splice(0, 1, std::vector<js_string>{js_string("baz")});
+		CheckArray(jarrstr, "[\"baz\",\"bar\"]");
+	}
+	{
+		std::vector<js_unknown> vecjunk;
+		vecjunk.emplace_back(emscripten::val::object());
+		vecjunk.emplace_back(emscripten::val::null());
+		tc::js::Array<js_unknown> jarrjunk(tc::jst::create_js_object, vecjunk);
+		CheckArray(jarrjunk, "[{},null]");
+		_ASSERT(jarrjunk[0].getEmval().strictlyEquals(vecjunk[0].getEmval()));
+	}
+
+	std::cout << "Success!\n";
+	return 0;
+}
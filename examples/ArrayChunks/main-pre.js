@@ -0,0 +1,17 @@
+Module.makeNumbers = function(n) {
+    const arr = new Array(n);
+    for (let i = 0; i < n; ++i) arr[i] = i;
+    return arr;
+}
+
+Module.makeBools = function(n) {
+    const arr = new Array(n);
+    for (let i = 0; i < n; ++i) arr[i] = (i % 3 == 0);
+    return arr;
+}
+
+Module.makeObjects = function(n) {
+    const arr = new Array(n);
+    for (let i = 0; i < n; ++i) arr[i] = { i: i, str: "s" + i };
+    return arr;
+}
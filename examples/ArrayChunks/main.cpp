@@ -0,0 +1,73 @@
+#include <emscripten/val.h>
+#include <iostream>
+#include <string>
+#include "explicit_cast.h"
+#include "range.h"
+#include "range_defines.h"
+#include "js_types.h"
+#include "js_bootstrap.h"
+
+using tc::jst::js_string;
+using tc::jst::js_unknown;
+
+int main() {
+	// More elements than fit into one chunk.
+	int const n = tc::jst::range_detail::c_nArrayChunkSize * 2 + 10;
+	{
+		auto const jarrdbl = tc::js::Array<double>(emscripten::val::module_property("makeNumbers")(n));
+		auto const vecdbl = tc::make_vector(jarrdbl);
+		_ASSERTEQUAL(tc::size(vecdbl), n);
+		for(int i = 0; i < n; ++i) {
+			_ASSERTEQUAL(vecdbl[i], i);
+		}
+		_ASSERTEQUAL(tc::accumulate(jarrdbl, 0.0, fn_assign_plus()), n * (n - 1) / 2.0);
+
+		// Iterating backwards reads the chunks which end at the current element.
+		auto it = tc::end(jarrdbl);
+		for(int i = n - 1; 0 <= i; --i) {
+			--it;
+			_ASSERTEQUAL(*it, i);
+		}
+
+		// Iterators at distant positions, as in std::reverse, each find their chunk in the shared cache.
+		auto itFront = tc::begin(jarrdbl);
+		auto itBack = tc::end(jarrdbl);
+		for(int i = 0; i < n / 2; ++i) {
+			--itBack;
+			_ASSERTEQUAL(*itFront, i);
+			_ASSERTEQUAL(*itBack, n - 1 - i);
+			++itFront;
+		}
+	}
+	{
+		auto const jarrb = tc::js::Array<bool>(emscripten::val::module_property("makeBools")(n));
+		int i = 0;
+		tc::for_each(jarrb, [&](bool b) noexcept {
+			_ASSERTEQUAL(b, 0 == i % 3);
+			++i;
+		});
+		_ASSERTEQUAL(i, n);
+	}
+	{
+		auto const jarrjunk = tc::js::ReadonlyArray<js_unknown>(emscripten::val::module_property("makeObjects")(n));
+		int i = 0;
+		tc::for_each(jarrjunk, [&](js_unknown const& junk) noexcept {
+			_ASSERTEQUAL(junk.getEmval()["i"].as<int>(), i);
+			_ASSERTEQUAL(junk.getEmval()["str"].as<std::string>(), tc::make_str("s", tc::as_dec(i)));
+			++i;
+		});
+		_ASSERTEQUAL(i, n);
+	}
+	{
+		auto const jarrstr = tc::js::Array<js_string>(emscripten::val::array());
+		jarrstr->push(js_string("foo"));
+		jarrstr->push(js_string("bar"));
+		auto const vecstr = tc::make_vector(tc::transform(jarrstr, tc::fn_explicit_cast<std::string>()));
+		_ASSERTEQUAL(tc::size(vecstr), 2);
+		_ASSERTEQUAL(vecstr[1], "bar");
+		_ASSERT(tc::empty(tc::js::Array<double>(emscripten::val::array())));
+	}
+
+	std::cout << "Success!\n";
+	return 0;
+}
@@ -0,0 +1,25 @@
+Module.assertEquals = function(got, expected) {
+   if (got !== expected) throw new Error('Got ' + got + ', expected ' + expected);
+}
+
+Module.consoleCalls = [];
+['log', 'error', 'warn', 'debug'].forEach(function(strMethod) {
+    const fnOriginal = console[strMethod];
+    console[strMethod] = function(str) {
+        Module.consoleCalls.push(strMethod + ':' + str);
+        fnOriginal.apply(console, arguments);
+    };
+});
+
+Module.checkConsoleCalls = function(astrExpected) {
+    Module.assertEquals(Module.consoleCalls.length, astrExpected.length);
+    for (let i = 0; i < astrExpected.length; ++i) {
+        Module.assertEquals(Module.consoleCalls[i], astrExpected[i]);
+    }
+    Module.consoleCalls = [];
+}
+
+process.on("exit", () => {
+    // The last batch is flushed on the microtask boundary after main() returns.
+    Module.checkConsoleCalls(['log:scheduled 1\nscheduled 2']);
+});
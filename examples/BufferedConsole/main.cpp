@@ -0,0 +1,45 @@
+#include <emscripten/val.h>
+#include <vector>
+#include "explicit_cast.h"
+#include "range.h"
+#include "range_defines.h"
+#include "js_types.h"
+#include "js_log.h"
+
+void CheckConsoleCalls(std::vector<char const*> const& vecszExpected) noexcept {
+	emscripten::val jarr = emscripten::val::array();
+	tc::for_each(vecszExpected, [&](char const* sz) noexcept {
+		jarr.call<void>("push", emscripten::val(sz));
+	});
+	emscripten::val::module_property("checkConsoleCalls")(jarr);
+}
+
+int main() {
+	{
+		tc::jst::js_buffered_console console;
+		console.log("line ", tc::as_dec(1));
+		console.log("line ", tc::as_dec(2));
+		console.error("failure");
+		console.log("line ", tc::as_dec(3));
+		CheckConsoleCalls({});
+
+		console.flush();
+		CheckConsoleCalls({"log:line 1\nline 2", "error:failure", "log:line 3"});
+
+		console.warn("flushed on destruction");
+	}
+	CheckConsoleCalls({"warn:flushed on destruction"});
+
+	{
+		tc::jst::js_buffered_console console(/*cchFlushThreshold*/ 8);
+		console.debug("1234");
+		CheckConsoleCalls({});
+		console.debug("5678");
+		CheckConsoleCalls({"debug:1234\n5678"});
+	}
+
+	tc::jst::buffered_console().log("scheduled 1");
+	tc::jst::buffered_console().log("scheduled 2");
+	CheckConsoleCalls({});
+	return 0;
+}
@@ -0,0 +1,37 @@
+let nProduced = 0;
+
+Module.countTo = function*(n) {
+    for (let i = 0; i < n; ++i) {
+        ++nProduced;
+        yield i;
+    }
+}
+
+Module.producedCount = function() {
+    const n = nProduced;
+    nProduced = 0;
+    return n;
+}
+
+Module.words = function*() {
+    yield 'foo';
+    yield 'bar';
+    yield 'baz';
+}
+
+Module.countToAsync = async function*(n) {
+    for (let i = 0; i < n; ++i) {
+        await new Promise(resolve => setTimeout(resolve, 0));
+        yield i;
+    }
+}
+
+let bAsyncTestFinished = false;
+Module.finishAsyncTest = function(sum) {
+    if (sum !== 45) throw new Error('Got ' + sum + ', expected 45');
+    bAsyncTestFinished = true;
+}
+
+process.on('exit', () => {
+    if (!bAsyncTestFinished) throw new Error('Async iteration did not complete');
+});
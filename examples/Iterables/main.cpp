@@ -0,0 +1,81 @@
+#include <emscripten/val.h>
+#include <coroutine>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <vector>
+#include "explicit_cast.h"
+#include "range.h"
+#include "range_defines.h"
+#include "js_types.h"
+#include "js_callback.h"
+#include "js_bootstrap.h"
+#include "js_coroutine.h"
+
+using tc::jst::js_string;
+
+namespace {
+	// Minimal coroutine type which starts immediately and destroys itself when done. The JS event loop keeps the
+	// process alive while the coroutine waits for chunks.
+	struct SDetachedTask final {
+		struct promise_type final {
+			SDetachedTask get_return_object() noexcept { return {}; }
+			std::suspend_never initial_suspend() noexcept { return {}; }
+			std::suspend_never final_suspend() noexcept { return {}; }
+			void return_void() noexcept {}
+			void unhandled_exception() noexcept { _ASSERTFALSE; }
+		};
+	};
+
+	SDetachedTask SumAsync(tc::js::AsyncIterable<double> jaitdbl) noexcept {
+		auto reader = jaitdbl->read_chunked(4);
+		double dblSum = 0;
+		for(;;) {
+			auto ojarrdbl = co_await tc::jst::next_chunk_awaitable(reader);
+			_ASSERT(ojarrdbl);
+			tc::for_each(*ojarrdbl, [&](double dbl) noexcept {
+				dblSum += dbl;
+			});
+			if((*ojarrdbl)->length() < reader.chunk_size()) {
+				break; // The async generator only continues when the next chunk is awaited.
+			}
+		}
+		emscripten::val::module_property("finishAsyncTest")(dblSum);
+	}
+}
+
+int main() {
+	{
+		tc::js::Iterable<double> jitdbl(emscripten::val::module_property("countTo")(10000));
+		double dblSum = 0;
+		for(double dbl : jitdbl->read_chunked(100)) {
+			dblSum += dbl;
+		}
+		_ASSERTEQUAL(dblSum, 10000 * 9999 / 2.0);
+		_ASSERTEQUAL(emscripten::val::module_property("producedCount")().as<double>(), 10000);
+	}
+	{
+		tc::js::Iterable<double> jitdbl(emscripten::val::module_property("countTo")(10000));
+		int n = 0;
+		for(double dbl : jitdbl->read_chunked(100)) {
+			_ASSERTEQUAL(dbl, n);
+			if(10 == ++n) {
+				break;
+			}
+		}
+		// Only the first chunk has been requested from the generator.
+		_ASSERTEQUAL(emscripten::val::module_property("producedCount")().as<double>(), 100);
+	}
+	{
+		tc::js::Iterable<js_string> jitstr(emscripten::val::module_property("words")());
+		std::vector<std::string> vecstr;
+		for(js_string const& jstr : jitstr->read_chunked(2)) {
+			vecstr.emplace_back(tc::explicit_cast<std::string>(jstr));
+		}
+		_ASSERT((std::vector<std::string>{"foo", "bar", "baz"}) == vecstr);
+	}
+	SumAsync(tc::js::AsyncIterable<double>(emscripten::val::module_property("countToAsync")(10)));
+
+	std::cout << "Success! If no exception follows, the async iteration completed.\n";
+	return 0;
+}
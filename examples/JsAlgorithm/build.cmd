@@ -0,0 +1,2 @@
+@call ../../build-config.cmd
+python ../../ninja.py main.emscripten debug
@@ -0,0 +1,7 @@
+Module.makeItems = function() {
+    return [
+        {name: 'apple', price: 3, available: true},
+        {name: 'pear', price: 2, available: false},
+        {name: 'plum', price: 5, available: true}
+    ];
+}
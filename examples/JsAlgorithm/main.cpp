@@ -0,0 +1,51 @@
+#include <emscripten/val.h>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "explicit_cast.h"
+#include "range.h"
+#include "range_defines.h"
+#include "js_types.h"
+#include "js_bootstrap.h"
+#include "js_algorithm.h"
+
+using tc::jst::js_string;
+using tc::jst::js_unknown;
+namespace js_pred = tc::jst::js_pred;
+
+int main() {
+	{
+		tc::js::Array<double> jarrdbl(tc::jst::create_js_object, std::vector<double>{3, 1, 4, 1, 5});
+		_ASSERTEQUAL(tc::jst::sum(jarrdbl), 14);
+		_ASSERTEQUAL(tc::accumulate(jarrdbl, 1.0, fn_assign_plus()), 15);
+		_ASSERTEQUAL(*tc::jst::min(jarrdbl), 1);
+		_ASSERTEQUAL(*tc::jst::max(jarrdbl), 5);
+		_ASSERTEQUAL(tc::jst::count_if(jarrdbl, js_pred::equal_to(1.0)), 2);
+		_ASSERTEQUAL(*tc::jst::find_first_if(jarrdbl, js_pred::greater(3.0)), 4);
+		_ASSERT(!tc::jst::find_first_if(jarrdbl, js_pred::greater(5.0)));
+		_ASSERTEQUAL(tc::jst::filter(jarrdbl, js_pred::less_equal(3.0))->length(), 3);
+
+		tc::js::ReadonlyArray<double> jrarrdbl(jarrdbl);
+		_ASSERTEQUAL(tc::jst::sum(jrarrdbl), 14);
+		_ASSERTEQUAL(tc::accumulate(jrarrdbl, 0.0, fn_assign_plus()), 14);
+
+		tc::js::Array<double> jarrdblEmpty(tc::jst::create_js_object);
+		_ASSERT(!tc::jst::min(jarrdblEmpty));
+	}
+	{
+		tc::js::Array<js_unknown> jarrjunkItem(emscripten::val::module_property("makeItems")());
+		_ASSERTEQUAL(tc::jst::count_if(jarrjunkItem, js_pred::property("available", js_pred::truthy())), 2);
+
+		tc::js::Array<js_unknown> jarrjunkCheap = tc::jst::filter(jarrjunkItem, js_pred::property("price", js_pred::less(4.0)));
+		std::vector<std::string> vecstrName;
+		tc::for_each(tc::jst::transform_property<js_string>(jarrjunkCheap, "name"), [&](js_string const& jstr) noexcept {
+			vecstrName.emplace_back(tc::explicit_cast<std::string>(jstr));
+		});
+		_ASSERT((std::vector<std::string>{"apple", "pear"}) == vecstrName);
+
+		_ASSERTEQUAL(tc::jst::sum(tc::jst::transform_property<double>(jarrjunkItem, "price")), 10);
+	}
+
+	std::cout << "Success!\n";
+	return 0;
+}
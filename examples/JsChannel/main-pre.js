@@ -0,0 +1,24 @@
+Module.produce = function(producer, n) {
+    // A browser main thread should rather retry from a later task, node can wait for the consumer thread in a loop.
+    function write(nType, data) {
+        while (!producer.tryWrite(nType, data)) {}
+    }
+    write(2, "started");
+    const frame = new Float64Array(2);
+    for (let i = 0; i < n; ++i) {
+        frame[0] = i;
+        frame[1] = 0.5;
+        write(1, frame);
+    }
+    write(2, "finished");
+}
+
+Module.rejectsLargeMessage = function(producer) {
+    try {
+        producer.tryWrite(1, new Uint8Array(producer.maxMessageSize + 1));
+        return false;
+    } catch (e) {
+        producer.close();
+        return e instanceof RangeError;
+    }
+}
@@ -0,0 +1,54 @@
+#include <emscripten/val.h>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include "range.h"
+#include "range_defines.h"
+#include "js_types.h"
+#include "js_channel.h"
+
+namespace {
+	// Must match main-pre.js
+	constexpr std::uint32_t c_nTypeFrame = 1;
+	constexpr std::uint32_t c_nTypeLog = 2;
+	constexpr int c_nFrames = 10000;
+}
+
+int main() {
+	// Much smaller than the total size of the messages, so the producer has to wait for the consumer and the buffer wraps around.
+	tc::jst::js_channel channel(4096);
+
+	double dblSum = 0;
+	int nFrames = 0;
+	std::string strLog;
+	std::thread thrdConsumer([&]() noexcept {
+		while(channel.wait()) {
+			channel.consume([&](tc::jst::js_channel_message const& msg) noexcept {
+				switch(msg.m_nType) {
+					case c_nTypeFrame:
+						_ASSERTEQUAL(msg.span<double>().size(), 2);
+						dblSum += msg.span<double>()[0] * msg.span<double>()[1];
+						++nFrames;
+						break;
+					case c_nTypeLog:
+						strLog += msg.string_view();
+						strLog += '\n';
+						break;
+					default:
+						_ASSERTFALSE;
+				}
+			});
+		}
+	});
+
+	{
+		tc::jst::js_unknown const junkProducer = channel.producer();
+		emscripten::val::module_property("produce")(junkProducer, c_nFrames);
+		_ASSERT(emscripten::val::module_property("rejectsLargeMessage")(junkProducer).as<bool>());
+	}
+	thrdConsumer.join();
+
+	_ASSERTEQUAL(nFrames, c_nFrames);
+	_ASSERTEQUAL(dblSum, 0.5 * c_nFrames * (c_nFrames - 1));
+	_ASSERT(strLog == "started\nfinished\n");
+}
@@ -0,0 +1,14 @@
+Module.makeStringArray = function() {
+    return ["foo", "bar", "foo", "baz", "bar"];
+}
+
+const objA = { name: "a" };
+const objB = { name: "b" };
+
+Module.objectA = function() {
+    return objA;
+}
+
+Module.makeObjectArray = function() {
+    return [objA, objB, objA, { name: "a" }];
+}
@@ -0,0 +1,74 @@
+#include <emscripten/val.h>
+#include <iostream>
+#include <unordered_map>
+#include "explicit_cast.h"
+#include "range.h"
+#include "range_defines.h"
+#include "js_types.h"
+#include "js_bootstrap.h"
+#include "js_intern.h"
+
+using tc::jst::js_string;
+using tc::jst::js_string_id;
+using tc::jst::js_string_interner;
+
+int main() {
+	js_string_interner interner;
+	_ASSERTEQUAL(interner.size(), 0);
+
+	js_string_id const idFoo = interner.intern(js_string("foo"));
+	js_string_id const idBar = interner.intern(js_string("bar"));
+	_ASSERT(idFoo != idBar);
+	_ASSERT(idFoo == interner.intern(js_string("foo")));
+	_ASSERTEQUAL(interner.size(), 2);
+
+	_ASSERT(interner.find(js_string("bar")) == idBar);
+	_ASSERT(!interner.find(js_string("baz")));
+	_ASSERTEQUAL(interner.size(), 2);
+
+	_ASSERTEQUAL(tc::explicit_cast<std::string>(interner.lookup(idBar)), "bar");
+
+	{
+		auto const vecid = interner.intern(tc::js::Array<js_string>(emscripten::val::module_property("makeStringArray")()));
+		_ASSERTEQUAL(tc::size(vecid), 5);
+		_ASSERT(idFoo == vecid[0]);
+		_ASSERT(idBar == vecid[1]);
+		_ASSERT(idFoo == vecid[2]);
+		_ASSERT(idBar == vecid[4]);
+		_ASSERTEQUAL(interner.size(), 3);
+
+		auto const jarrstr = interner.lookup(vecid);
+		_ASSERTEQUAL(jarrstr->length(), 5);
+		_ASSERTEQUAL(tc::explicit_cast<std::string>(jarrstr[3]), "baz");
+	}
+
+	std::unordered_map<js_string_id, int> mapidn;
+	++mapidn[interner.intern(js_string("foo"))];
+	++mapidn[interner.intern(js_string("foo"))];
+	_ASSERTEQUAL(mapidn[idFoo], 2);
+
+	{
+		// Identity, not structural equality: the last element looks like objA, but is a different object.
+		tc::jst::js_object const jobjA(emscripten::val::module_property("objectA")());
+		auto const jarrjobj = tc::js::Array<tc::jst::js_object>(emscripten::val::module_property("makeObjectArray")());
+		auto const vecid = tc::jst::identity_ids(jarrjobj);
+		_ASSERTEQUAL(tc::size(vecid), 4);
+		_ASSERT(tc::jst::identity_id(jobjA) == vecid[0]);
+		_ASSERT(vecid[0] == vecid[2]);
+		_ASSERT(vecid[0] != vecid[1]);
+		_ASSERT(vecid[0] != vecid[3]);
+
+		tc::jst::js_identity_map<tc::jst::js_object, int> mapjobjn;
+		tc::for_each(jarrjobj, [&](tc::jst::js_object const& jobj) noexcept {
+			++mapjobjn[jobj];
+		});
+		_ASSERTEQUAL(mapjobjn.size(), 3);
+		_ASSERTEQUAL(*mapjobjn.find(jobjA), 2);
+		_ASSERT(!mapjobjn.try_emplace(jobjA, 0).second);
+		_ASSERT(mapjobjn.erase(jobjA));
+		_ASSERT(!mapjobjn.find(vecid[0]));
+	}
+
+	std::cout << "Success!\n";
+	return 0;
+}
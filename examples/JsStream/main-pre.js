@@ -0,0 +1,38 @@
+const { Readable, Writable } = require('stream');
+
+let strExpected = '';
+
+Module.createSource = function() {
+    function* lines() {
+        for (let i = 0; i < 10000; ++i) {
+            const str = 'line ' + i + ' of the input\n';
+            strExpected += str.toUpperCase();
+            // Readable.from passes strings and Buffers unchanged.
+            yield i % 2 ? str : Buffer.from(str);
+        }
+    }
+    return Readable.from(lines());
+}
+
+const vecbufWritten = [];
+Module.createSink = function() {
+    return new Writable({
+        highWaterMark: 4096,
+        write: function(chunk, encoding, callback) {
+            vecbufWritten.push(chunk);
+            setTimeout(callback, 0); // A slow sink, write has to wait for 'drain'.
+        }
+    });
+}
+
+let bStreamTestFinished = false;
+Module.finishStreamTest = function(cb) {
+    const strWritten = Buffer.concat(vecbufWritten).toString();
+    if (strWritten !== strExpected) throw new Error('Output does not match the input');
+    if (cb !== Buffer.byteLength(strExpected)) throw new Error('Got ' + cb + ' bytes, expected ' + Buffer.byteLength(strExpected));
+    bStreamTestFinished = true;
+}
+
+process.on('exit', () => {
+    if (!bStreamTestFinished) throw new Error('Streaming did not complete');
+});
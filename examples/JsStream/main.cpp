@@ -0,0 +1,68 @@
+#include <emscripten/val.h>
+#include <array>
+#include <cstddef>
+#include <iostream>
+#include <optional>
+#include <span>
+#include "range.h"
+#include "range_defines.h"
+#include "js_types.h"
+#include "js_callback.h"
+#include "js_bootstrap.h"
+#include "js_stream.h"
+
+namespace {
+	std::optional<tc::jst::js_stream_reader> g_oreader;
+	std::optional<tc::jst::js_stream_writer> g_owriter;
+	// Much smaller than the input, so the input is read and written in many chunks, some of which are split across reads.
+	std::array<std::byte, 1000> g_abyBuffer;
+	double g_cbTotal = 0;
+
+	void Pump() noexcept;
+
+	auto const& OnWritten() noexcept {
+		static auto const fn = tc::jst::js_lambda_wrap([](tc::jst::js_undefined) noexcept {
+			// The sink has accepted the chunk, continue with the next one.
+			Pump();
+		});
+		return fn;
+	}
+
+	auto const& OnEnded() noexcept {
+		static auto const fn = tc::jst::js_lambda_wrap([](tc::jst::js_undefined) noexcept {
+			emscripten::val::module_property("finishStreamTest")(g_cbTotal);
+		});
+		return fn;
+	}
+
+	auto const& OnRead() noexcept {
+		static auto const fn = tc::jst::js_lambda_wrap([](double dblRead) noexcept {
+			if(0 == dblRead) {
+				g_owriter->end()->then(OnEnded());
+				return;
+			}
+			auto const spanby = std::span<std::byte>(g_abyBuffer).first(static_cast<std::size_t>(dblRead));
+			for(std::byte& by : spanby) {
+				if(std::byte{'a'} <= by && by <= std::byte{'z'}) {
+					by = std::byte{static_cast<unsigned char>(static_cast<unsigned char>(by) - 'a' + 'A')};
+				}
+			}
+			g_cbTotal += dblRead;
+			g_owriter->write(spanby)->then(OnWritten());
+		});
+		return fn;
+	}
+
+	void Pump() noexcept {
+		g_oreader->read(g_abyBuffer)->then(OnRead());
+	}
+}
+
+int main() {
+	g_oreader.emplace(tc::jst::js_unknown(emscripten::val::module_property("createSource")()));
+	g_owriter.emplace(tc::jst::js_unknown(emscripten::val::module_property("createSink")()));
+	Pump();
+
+	std::cout << "Success! If no exception follows, the stream has been copied.\n";
+	return 0;
+}
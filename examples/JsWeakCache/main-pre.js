@@ -0,0 +1,36 @@
+let documents = [{ text: "a" }, { text: "bb" }, { text: "ccc" }];
+
+Module.documents = function() {
+    return documents;
+}
+
+Module.lengthOf = function(document) {
+    return document.text.length;
+}
+
+Module.dropDocuments = function(n) {
+    documents = documents.slice(n);
+}
+
+let bWeakCacheTestFinished = false;
+Module.checkAfterCollection = function(fnCheck) {
+    // Finalization is only guaranteed to be reported eventually, retry after collecting garbage.
+    let nAttempts = 0;
+    function attempt() {
+        global.gc();
+        setTimeout(function() {
+            if (fnCheck()) {
+                bWeakCacheTestFinished = true;
+            } else if (++nAttempts < 100) {
+                attempt();
+            } else {
+                throw new Error('Entries of collected keys have not been purged');
+            }
+        }, 10);
+    }
+    attempt();
+}
+
+process.on('exit', () => {
+    if (!bWeakCacheTestFinished) throw new Error('Weak cache test did not complete');
+});
@@ -0,0 +1,57 @@
+#include <emscripten/val.h>
+#include <iostream>
+#include "range.h"
+#include "range_defines.h"
+#include "js_types.h"
+#include "js_callback.h"
+#include "js_bootstrap.h"
+#include "js_weak.h"
+
+using tc::jst::js_object;
+
+namespace {
+	struct SDerived final {
+		double m_dblLength;
+	};
+
+	tc::jst::js_weak_cache<js_object, SDerived>& Cache() noexcept {
+		static tc::jst::js_weak_cache<js_object, SDerived> cache;
+		return cache;
+	}
+
+	int g_nComputed = 0;
+
+	SDerived Compute(js_object const& jobjDocument) noexcept {
+		++g_nComputed;
+		return SDerived{emscripten::val::module_property("lengthOf")(jobjDocument).as<double>()};
+	}
+}
+
+int main() {
+	{
+		tc::js::Array<js_object> const jarrjobjDocument(emscripten::val::module_property("documents")());
+		for(int i = 0; i < 2; ++i) {
+			tc::for_each(jarrjobjDocument, [&](js_object const& jobjDocument) noexcept {
+				Cache().find_or_create(jobjDocument, Compute);
+			});
+		}
+		_ASSERTEQUAL(g_nComputed, 3);
+		_ASSERTEQUAL(Cache().find(jarrjobjDocument[2])->m_dblLength, 3);
+
+		tc::jst::js_weak_ref<js_object> const jweak(jarrjobjDocument[0]);
+		_ASSERT(jweak.lock());
+	}
+	_ASSERTEQUAL(Cache().size(), 3);
+
+	// JS drops the first two documents. The cache must not keep them alive, so they are eventually collected
+	// and their entries are removed.
+	emscripten::val::module_property("dropDocuments")(2);
+	static auto const fnCheck = tc::jst::js_lambda_wrap([]() noexcept {
+		Cache().purge();
+		return 1 == Cache().size();
+	});
+	emscripten::val::module_property("checkAfterCollection")(fnCheck);
+
+	std::cout << "Success! If no exception follows, the collected keys have been purged.\n";
+	return 0;
+}
@@ -0,0 +1,2 @@
+@call ..\..\build-config.cmd || exit /b 1
+node --expose-gc main.js
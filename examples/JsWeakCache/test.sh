@@ -0,0 +1,4 @@
+#!/bin/bash
+set -ueo pipefail
+source ../../build-config.sh
+node --expose-gc main.js
@@ -0,0 +1,20 @@
+Module.assertEquals = function(got, expected) {
+   if (got !== expected) throw new Error('Got ' + got + ', expected ' + expected);
+}
+
+Module.makeObject = function() {
+    return {
+        name: "line\n\"quoted\" bär €",
+        count: 42,
+        ratio: -1.5e-3,
+        flags: [true, false, null],
+        nested: { emoji: "😀", empty: {} },
+        skipped: undefined
+    };
+}
+
+Module.checkObject = function(obj) {
+    Module.assertEquals(obj.a, 1);
+    Module.assertEquals(obj.b.length, 2);
+    Module.assertEquals(obj.b[1], "wörld");
+}
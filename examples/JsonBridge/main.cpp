@@ -0,0 +1,94 @@
+#include <emscripten/val.h>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <string_view>
+#include "explicit_cast.h"
+#include "range.h"
+#include "range_defines.h"
+#include "tc_move.h"
+#include "js_types.h"
+#include "js_bootstrap.h"
+#include "js_json.h"
+
+using tc::jst::js_unknown;
+using tc::jst::json_array;
+using tc::jst::json_object;
+
+namespace {
+// Keeps only the last number, enough to check what the parser accepts.
+struct SLastNumber final {
+	double m_dbl = 0;
+	void null() & noexcept {}
+	void boolean(bool) & noexcept {}
+	void number(double dbl) & noexcept { m_dbl = dbl; }
+	void string(std::string_view) & noexcept {}
+	void key(std::string_view) & noexcept {}
+	void begin_object() & noexcept {}
+	void end_object() & noexcept {}
+	void begin_array() & noexcept {}
+	void end_array() & noexcept {}
+};
+
+bool ParseJson(std::string str, SLastNumber& handler) noexcept {
+	return tc::jst::parse_json_in_place(str.data(), str.data() + str.size(), handler);
+}
+
+bool IsJson(std::string str) noexcept {
+	SLastNumber handler;
+	return ParseJson(tc_move(str), handler);
+}
+} // namespace
+
+int main() {
+	{
+		auto ojsonbuf = tc::jst::to_json_buffer(js_unknown(emscripten::val::module_property("makeObject")()));
+		_ASSERT(ojsonbuf);
+		auto const odoc = tc::jst::parse_json(tc_move(*ojsonbuf));
+		_ASSERT(odoc);
+		auto const& jvRoot = odoc->root();
+		_ASSERTEQUAL(tc::size(*jvRoot.get_if<json_object>()), 5); // undefined members are dropped by JSON.stringify
+		_ASSERTEQUAL(*jvRoot.find("name")->get_if<std::string_view>(), "line\n\"quoted\" b\xC3\xA4r \xE2\x82\xAC");
+		_ASSERTEQUAL(*jvRoot.find("count")->get_if<double>(), 42);
+		_ASSERTEQUAL(*jvRoot.find("ratio")->get_if<double>(), -1.5e-3);
+		auto const& jarr = *jvRoot.find("flags")->get_if<json_array>();
+		_ASSERTEQUAL(tc::size(jarr), 3);
+		_ASSERT(*jarr[0].get_if<bool>());
+		_ASSERT(!*jarr[1].get_if<bool>());
+		_ASSERT(jarr[2].is_null());
+		auto const pjvNested = jvRoot.find("nested");
+		_ASSERTEQUAL(*pjvNested->find("emoji")->get_if<std::string_view>(), "\xF0\x9F\x98\x80");
+		_ASSERT(tc::empty(*pjvNested->find("empty")->get_if<json_object>()));
+		_ASSERT(!jvRoot.find("skipped"));
+	}
+	_ASSERT(!tc::jst::to_json_buffer(js_unknown(emscripten::val::undefined())));
+	{
+		auto const ojsonbuf = tc::jst::to_json_buffer(js_unknown(emscripten::val::module_property("makeObject")()));
+		_ASSERT(ojsonbuf);
+		_ASSERT(tc::jst::from_json_buffer(ojsonbuf->str()).getEmval()["nested"]["emoji"].as<std::string>() == "\xF0\x9F\x98\x80");
+	}
+	{
+		_ASSERT(IsJson("[0, -0, 10, 0.5, 1e3]"));
+		_ASSERT(!IsJson("[01]"));
+		_ASSERT(!IsJson("-01"));
+		_ASSERT(IsJson("\"a\\u0001\""));
+		_ASSERT(!IsJson("\"a\x01\""));
+		_ASSERT(!IsJson("\"a\tb\""));
+
+		SLastNumber handler;
+		_ASSERT(ParseJson("-1.5e-3", handler));
+		_ASSERTEQUAL(handler.m_dbl, -1.5e-3);
+		_ASSERT(ParseJson("1e400", handler));
+		_ASSERTEQUAL(handler.m_dbl, std::numeric_limits<double>::infinity());
+		_ASSERT(ParseJson("-0.001e-400", handler));
+		_ASSERTEQUAL(handler.m_dbl, 0.0);
+
+		int const nDepthMax = tc::jst::json_detail::c_nJsonDepthMax;
+		_ASSERT(IsJson(std::string(nDepthMax, '[') + std::string(nDepthMax, ']')));
+		_ASSERT(!IsJson(std::string(nDepthMax + 1, '[') + std::string(nDepthMax + 1, ']')));
+	}
+	emscripten::val::module_property("checkObject")(tc::jst::from_json_buffer(R"({"a": 1, "b": ["hello", "wörld"]})"));
+
+	std::cout << "Success!\n";
+	return 0;
+}
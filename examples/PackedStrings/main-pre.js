@@ -0,0 +1,14 @@
+Module.assertEquals = function(got, expected) {
+   if (got !== expected) throw new Error('Got ' + got + ', expected ' + expected);
+}
+
+Module.makeStringArray = function() {
+    return ["foo", "", "bär", "€"];
+}
+
+Module.checkStringArray = function(arr) {
+    Module.assertEquals(arr.length, 3);
+    Module.assertEquals(arr[0], "hello");
+    Module.assertEquals(arr[1], "");
+    Module.assertEquals(arr[2], "wörld");
+}
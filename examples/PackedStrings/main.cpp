@@ -0,0 +1,38 @@
+#include <emscripten/val.h>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "explicit_cast.h"
+#include "range.h"
+#include "range_defines.h"
+#include "js_types.h"
+#include "js_bootstrap.h"
+#include "js_marshal.h"
+
+using tc::jst::js_string;
+
+int main() {
+	{
+		auto const packedstr = tc::jst::to_packed_utf8(tc::js::Array<js_string>(emscripten::val::module_property("makeStringArray")()));
+		_ASSERTEQUAL(tc::size(packedstr), 4);
+		_ASSERTEQUAL(packedstr[0], "foo");
+		_ASSERT(tc::empty(packedstr[1]));
+		_ASSERTEQUAL(packedstr[2], "b\xC3\xA4r");
+		_ASSERTEQUAL(packedstr[3], "\xE2\x82\xAC");
+
+		std::size_t cch = 0;
+		tc::for_each(packedstr, [&](std::string_view sv) noexcept { cch += tc::size(sv); });
+		_ASSERTEQUAL(cch, 10);
+	}
+	{
+		auto const packedstr = tc::jst::to_packed_utf8(tc::js::Array<js_string>(emscripten::val::array()));
+		_ASSERT(tc::empty(packedstr));
+	}
+	{
+		std::vector<std::string> vecstr{"hello", "", "w\xC3\xB6rld"};
+		emscripten::val::module_property("checkStringArray")(tc::jst::make_js_string_array(vecstr));
+	}
+	std::cout << "Success!\n";
+	return 0;
+}
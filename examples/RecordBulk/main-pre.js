@@ -0,0 +1,12 @@
+Module.makeConfig = function(n) {
+    const rec = {};
+    for (let i = 0; i < n; ++i) {
+        rec['key' + i] = i;
+    }
+    return rec;
+}
+
+Module.checkRecord = function(rec, expected) {
+    const str = JSON.stringify(rec);
+    if (str !== expected) throw new Error('Got ' + str + ', expected ' + expected);
+}
@@ -0,0 +1,59 @@
+#include <emscripten/val.h>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+#include "explicit_cast.h"
+#include "range.h"
+#include "range_defines.h"
+#include "js_types.h"
+#include "js_bootstrap.h"
+#include "js_marshal.h"
+
+using tc::jst::js_string;
+
+namespace {
+	void CheckRecord(tc::jst::js_unknown const& junkRecord, char const* szExpected) noexcept {
+		emscripten::val::module_property("checkRecord")(junkRecord, js_string(szExpected));
+	}
+}
+
+int main() {
+	{
+		tc::js::Record<js_string, double> jrec(emscripten::val::module_property("makeConfig")(1000));
+		std::vector<double> const vecdbl = jrec->values();
+		_ASSERT(1000 == vecdbl.size());
+		_ASSERTEQUAL(vecdbl[999], 999);
+
+		std::vector<js_string> const vecjstr = jrec->keys();
+		_ASSERTEQUAL(tc::explicit_cast<std::string>(vecjstr[1]), "key1");
+
+		tc::jst::js_packed_strings const packedstr = tc::jst::to_packed_utf8_keys(jrec);
+		_ASSERT(1000 == packedstr.size());
+		_ASSERT("key999" == packedstr[999]);
+
+		auto const vecpairjstrdbl = jrec->entries();
+		_ASSERTEQUAL(tc::explicit_cast<std::string>(vecpairjstrdbl[2].first), "key2");
+		_ASSERTEQUAL(vecpairjstrdbl[2].second, 2);
+	}
+	{
+		std::map<std::string, double> mapstrdbl{{"a", 1}, {"b", 2}};
+		tc::js::Record<js_string, double> jrec(tc::jst::create_js_object, mapstrdbl);
+		CheckRecord(jrec, "{\"a\":1,\"b\":2}");
+	}
+	{
+		std::map<double, bool> mapdblb{{1, true}, {2, false}};
+		tc::js::Record<double, bool> jrec(tc::jst::create_js_object, mapdblb);
+		CheckRecord(jrec, "{\"1\":true,\"2\":false}");
+		_ASSERT((std::vector<double>{1, 2}) == jrec->keys());
+	}
+	{
+		std::map<std::string, js_string> mapstrjstr;
+		mapstrjstr.emplace("x", js_string("foo"));
+		tc::js::Record<js_string, js_string> jrec(tc::jst::create_js_object, mapstrjstr);
+		CheckRecord(jrec, "{\"x\":\"foo\"}");
+	}
+
+	std::cout << "Success!\n";
+	return 0;
+}
@@ -0,0 +1,8 @@
+Module.checkJson = function(value, expected) {
+    const str = JSON.stringify(value);
+    if (str !== expected) throw new Error('Got ' + str + ', expected ' + expected);
+}
+
+Module.isFloat64Array = function(value) {
+    return value instanceof Float64Array;
+}
@@ -0,0 +1,59 @@
+#include <emscripten/val.h>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "explicit_cast.h"
+#include "range.h"
+#include "range_defines.h"
+#include "js_types.h"
+#include "js_bootstrap.h"
+
+using tc::jst::js_string;
+
+enum class ESeries { revenue, cost };
+
+namespace tc::jst {
+template<> struct IsJsIntegralEnum<ESeries> : std::true_type {};
+}
+
+namespace {
+	struct SDataPoint final {
+		double x;
+		int y;
+		bool highlighted;
+		std::string label;
+		ESeries series;
+	};
+	TC_JS_STRUCT(SDataPoint, x, y, highlighted, label, series)
+
+	void CheckJson(tc::jst::js_unknown const& junk, char const* szExpected) noexcept {
+		emscripten::val::module_property("checkJson")(junk, js_string(szExpected));
+	}
+}
+
+int main() {
+	std::vector<SDataPoint> const vecdatapt{
+		{1.5, 10, false, "Jan", ESeries::revenue},
+		{2.5, -3, true, "Feb ä", ESeries::cost}
+	};
+
+	{
+		tc::js::Array<tc::jst::js_unknown> jarr(tc::jst::create_js_object, vecdatapt);
+		CheckJson(jarr,
+			"[{\"x\":1.5,\"y\":10,\"highlighted\":false,\"label\":\"Jan\",\"series\":0},"
+			"{\"x\":2.5,\"y\":-3,\"highlighted\":true,\"label\":\"Feb ä\",\"series\":1}]"
+		);
+	}
+	{
+		auto const jrecColumns = tc::jst::make_js_columns(vecdatapt);
+		_ASSERT(emscripten::val::module_property("isFloat64Array")(jrecColumns.getEmval()["x"]).as<bool>());
+		CheckJson(jrecColumns,
+			"{\"x\":{\"0\":1.5,\"1\":2.5},\"y\":{\"0\":10,\"1\":-3},\"highlighted\":[false,true],"
+			"\"label\":[\"Jan\",\"Feb ä\"],\"series\":{\"0\":0,\"1\":1}}"
+		);
+	}
+	{
+		tc::js::Array<tc::jst::js_unknown> jarr(tc::jst::create_js_object, std::vector<SDataPoint>());
+		CheckJson(jarr, "[]");
+	}
+}
@@ -0,0 +1,32 @@
+let viewKept;
+
+Module.total = function(view) {
+    viewKept = view;
+    return view.price * view.quantity;
+}
+
+Module.restock = function(view, n) {
+    view.quantity += n;
+    view.active = false;
+}
+
+Module.keys = function(view) {
+    const keys = [];
+    for (const key in view) {
+        keys.push(key);
+    }
+    return keys.join(',');
+}
+
+Module.flags = function(view) {
+    return view.flags;
+}
+
+Module.throwsOnKeptView = function() {
+    try {
+        viewKept.price;
+        return false;
+    } catch (e) {
+        return true;
+    }
+}
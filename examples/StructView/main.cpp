@@ -0,0 +1,40 @@
+#include <emscripten/val.h>
+#include <cstdint>
+#include <string>
+#include "explicit_cast.h"
+#include "range.h"
+#include "range_defines.h"
+#include "js_types.h"
+#include "js_bootstrap.h"
+#include "js_marshal.h"
+
+namespace {
+	struct SModel final {
+		double price;
+		int quantity;
+		bool active;
+		std::uint8_t flags;
+		std::string name; // not exposed by the view
+	};
+	TC_JS_STRUCT(SModel, price, quantity, active, flags, name)
+}
+
+int main() {
+	SModel model{2.5, 3, true, 0x80, "model"};
+	{
+		tc::jst::js_struct_view<SModel> const jview(model);
+		tc::jst::js_unknown const& junkView = jview;
+		// JS reads and writes the fields in place, nothing is copied.
+		_ASSERTEQUAL(emscripten::val::module_property("total")(junkView).as<double>(), 7.5);
+		emscripten::val::module_property("restock")(junkView, 10);
+		_ASSERTEQUAL(model.quantity, 13);
+		_ASSERT(!model.active);
+
+		model.price = 1;
+		_ASSERTEQUAL(emscripten::val::module_property("total")(junkView).as<double>(), 13);
+		_ASSERT(emscripten::val::module_property("keys")(junkView).as<std::string>() == "price,quantity,active,flags");
+		_ASSERTEQUAL(emscripten::val::module_property("flags")(junkView).as<int>(), 0x80);
+	}
+	// The view has been detached when jview was destroyed.
+	_ASSERT(emscripten::val::module_property("throwsOnKeptView")().as<bool>());
+}
@@ -0,0 +1,11 @@
+Module.sumTypedArray = function(ta) {
+    let sum = 0;
+    for (let i = 0; i < ta.length; ++i) {
+        sum += ta[i];
+    }
+    return sum;
+}
+
+Module.fillTypedArray = function(ta, value) {
+    ta.fill(value);
+}
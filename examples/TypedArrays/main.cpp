@@ -0,0 +1,56 @@
+#include <emscripten/val.h>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+#include "explicit_cast.h"
+#include "range.h"
+#include "range_defines.h"
+#include "js_types.h"
+#include "js_bootstrap.h"
+#include "js_marshal.h"
+
+namespace {
+	double SumTypedArray(tc::jst::js_unknown const& junkTypedArray) noexcept {
+		return emscripten::val::module_property("sumTypedArray")(junkTypedArray).as<double>();
+	}
+}
+
+int main() {
+	{
+		std::vector<double> vecdbl{1, 2, 3};
+		tc::js::Float64Array jtarrdbl(tc::jst::create_js_object, std::span<double const>(vecdbl));
+		_ASSERTEQUAL(jtarrdbl->length(), 3);
+		_ASSERTEQUAL(jtarrdbl[1], 2);
+		vecdbl[1] = 5; // jtarrdbl owns a copy
+		_ASSERTEQUAL(jtarrdbl[1], 2);
+
+		jtarrdbl->copy_from(std::span<double const>(vecdbl).subspan(1), 1);
+		_ASSERTEQUAL(SumTypedArray(jtarrdbl), 9);
+
+		std::vector<double> vecdblOut(2);
+		_ASSERTEQUAL(jtarrdbl->copy_to(vecdblOut), 2);
+		_ASSERTEQUAL(vecdblOut[1], 5);
+	}
+	{
+		tc::js::Uint8Array jtarrn(tc::jst::create_js_object, 4);
+		emscripten::val::module_property("fillTypedArray")(jtarrn, 255);
+		_ASSERTEQUAL(jtarrn[3], 255);
+		_ASSERTEQUAL(jtarrn->buffer()->byteLength(), 4);
+
+		tc::js::DataView jdv(tc::jst::create_js_object, jtarrn->buffer());
+		jdv->set<std::uint16_t>(0, 0x1234, /*bLittleEndian*/true);
+		_ASSERTEQUAL(jtarrn[0], 0x34);
+		_ASSERTEQUAL(jdv->get<std::uint16_t>(0, /*bLittleEndian*/false), 0x3412);
+	}
+	{
+		std::vector<std::int32_t> vecn(1000, 1);
+		tc::jst::js_heap_view<std::int32_t> heapview(vecn);
+		_ASSERTEQUAL(SumTypedArray(heapview.get()), 1000);
+		emscripten::val::module_property("fillTypedArray")(heapview.get(), 2); // JS writes directly into vecn
+		_ASSERTEQUAL(vecn[999], 2);
+		_ASSERT(heapview.valid()); // builds do not enable ALLOW_MEMORY_GROWTH, so the memory cannot have grown
+	}
+
+	std::cout << "Success!\n";
+	return 0;
+}
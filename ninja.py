@@ -59,10 +59,22 @@ if __name__ == "__main__":
 	
 	# read files that should be passed to emscripten as --pre-js arguments
 	strPreJsDependencies = ""
-	liststrPreJs = dictNinja.get("prejs", []) + ["${TCJSDIR}/bootstrap/src/js_callback.js"]
+	liststrPreJs = dictNinja.get("prejs", []) + [
+		"${TCJSDIR}/bootstrap/src/js_callback.js",
+		"${TCJSDIR}/bootstrap/src/js_intern.js",
+		"${TCJSDIR}/bootstrap/src/js_marshal.js",
+		"${TCJSDIR}/bootstrap/src/js_log.js",
+		"${TCJSDIR}/bootstrap/src/js_algorithm.js",
+		"${TCJSDIR}/bootstrap/src/js_channel.js",
+		"${TCJSDIR}/bootstrap/src/js_stream.js",
+		"${TCJSDIR}/bootstrap/src/js_weak.js"
+	]
 	strPreJsDependencies = " | " + " ".join(map(TransformSourcePath, liststrPreJs))
 
-	liststrCpp = dictNinja["cpp"] + ["${TCJSDIR}/bootstrap/src/js_callback.cpp"]
+	liststrCpp = dictNinja["cpp"] + [
+		"${TCJSDIR}/bootstrap/src/js_callback.cpp",
+		"${TCJSDIR}/bootstrap/src/js_marshal.cpp"
+	]
 
 	# calculate which files emscripten will output depending on the linker flags
 	strImplicitOutputs = ""
@@ -91,11 +103,15 @@ if __name__ == "__main__":
 		fBuildNinja.write("SRCDIR = " + args.srcdir + "\n")
 		fBuildNinja.write("TCJSDIR = " + strScriptDir + "\n")
 
+		# optional per-project flags, e.g. -pthread, which must be passed both to the compiler and the linker
 		fBuildNinja.write("CFLAGS = ${COMMON_CFLAGS} " 
-			+ ("${DEBUG_CFLAGS}" if args.config=="debug" else "${RELEASE_CFLAGS}") + "\n"
+			+ ("${DEBUG_CFLAGS}" if args.config=="debug" else "${RELEASE_CFLAGS}")
+			+ "".join(map(lambda strFlag: " " + strFlag, dictNinja.get("cflags", [])))
+			+ "\n"
 		)
 		fBuildNinja.write("LINK_FLAGS = ${COMMON_LINK_FLAGS} " 
 			+ ("${DEBUG_LINK_FLAGS}" if args.config=="debug" else "${RELEASE_LINK_FLAGS}")
+			+ "".join(map(lambda strFlag: " " + strFlag, dictNinja.get("linkflags", [])))
 			+ "".join(map(lambda strPreJs: " --pre-js " + TransformSourcePath(strPreJs), liststrPreJs))
 			+ "\n"
 		)
@@ -122,7 +138,7 @@ rule CXX_EXECUTABLE_LINKER
   restat = $RESTAT
 
 rule TCJS 
-  command = """ + ExecShellCommand("node ${TCJSDIR}/stage1/main.js $in > $out 2>${INTDIR}/tcjs.log") + """
+  command = """ + ExecShellCommand("node ${TCJSDIR}/stage1/main.js $TCJSFLAGS $in > $out 2>${INTDIR}/tcjs.log") + """
 
 """)
 
@@ -130,6 +146,14 @@ rule TCJS
 		dictTcJs = dictNinja.get("tcjs", None)
 		if dictTcJs:
 			fBuildNinja.write("\nbuild ${OUTDIR}/" + dictTcJs["output"] + ": TCJS " + " ".join(map(TransformSourcePath, dictTcJs["inputs"])))
+			# optional qualified class names or input files whose readonly properties are memoized,
+			# input files are passed like in inputs so they match the file names seen by typescript
+			liststrMemoize = dictTcJs.get("memoize", [])
+			if liststrMemoize:
+				fBuildNinja.write("\n  TCJSFLAGS =" + "".join(map(
+					lambda strMemoize: " --memoize=" + (TransformSourcePath(strMemoize) if strMemoize.endswith(".ts") else strMemoize),
+					liststrMemoize
+				)))
 			strTcJsDependencies = " | ${OUTDIR}/" + dictTcJs["output"]
 	
 		# Create paths for intermediate files inside INTDIR directory
@@ -9,6 +9,7 @@ using tc::jst::js_string;
 using tc::jst::js_unknown;
 
 extern std::optional<tc::js::ts::TypeChecker> g_ojtsTypeChecker;
+extern std::vector<std::string> g_vecstrMemoize;
 
 ECppType CppType(ts::Symbol jsymType) noexcept {
     ECppType ecpptype = ecpptypeIGNORE;
@@ -21,8 +22,9 @@ ECppType CppType(ts::Symbol jsymType) noexcept {
 	}
 
 	if(static_cast<bool>(ts::SymbolFlags::TypeAlias&jsymType->getFlags())) {
-		// Emit type aliases as using declarations if the type alias only references types, not e.g. literals
-		// A type alias of a single or a union of literals should be transformed into tag structs in C++
+		// Emit type aliases as using declarations if the type alias only references types, not e.g. literals.
+		// String literals in unions are fine, MangleType turns them into enum classes (see SJsStringLiteralUnion).
+		// A type alias of a single literal should be transformed into a tag struct in C++.
 		auto IsObject = [](auto jtypeInternal) noexcept {
 			switch(jtypeInternal->flags()) {
 			case ts::TypeFlags::Any:
@@ -49,7 +51,9 @@ ECppType CppType(ts::Symbol jsymType) noexcept {
             )
         )->type());
 		auto const ojuniontype = jtype->isUnion();
-		if((ojuniontype && tc::all_of((*ojuniontype)->types(), IsObject))
+		if((ojuniontype && tc::all_of((*ojuniontype)->types(), [&](auto jtypeOption) noexcept {
+			return IsObject(jtypeOption) || ts::TypeFlags::StringLiteral == jtypeOption->flags();
+		}))
 		|| IsObject(jtype)) {
 			ecpptype |= ecpptypeTYPEALIAS;
 		}
@@ -123,14 +127,14 @@ namespace {
    constexpr char const* c_apszReserved[] = {"alignas", "alignof", "and", "and_eq", "asm", "auto", "bitand", "bitor", "bool", "break", "case", "catch", "char", "char16_t", "char32_t", "class", "compl", "const", "constexpr", "const_cast", "continue", "decltype", "default", "delete", "do", "double", "dynamic_cast", "else", "enum", "explicit", "export", "extern", "false", "float", "for", "friend", "goto", "if", "inline", "int", "long", "mutable", "namespace", "new", "noexcept", "not", "not_eq", "nullptr", "operator", "or", "or_eq", "private", "protected", "public", "register", "reinterpret_cast", "return", "short", "signed", "sizeof", "static", "static_assert", "static_cast", "struct", "switch", "template", "this", "thread_local", "throw", "true", "try", "typedef", "typeid", "typename", "union", "unsigned", "using", "virtual", "void", "volatile", "wchar_t", "while", "xor", "xor_eq"};
 }
 
-// CppifyName returns the user-visible name that we export from namespaces/classes
-std::string CppifyName(ts::Symbol jsym, ENameContext enamectx) noexcept {
+// CppifyIdentifier replaces characters which are not allowed in C++ identifiers and avoids reserved words.
+std::string CppifyIdentifier(tc::ptr_range<char const> rngch) noexcept {
     // TODO: https://en.cppreference.com/w/cpp/language/identifiers
     // JavaScript identifiers are actually Unicode and C++ compilers support Unicode, 
     // so we are needlessly restrictive here. 
     std::string strResult;
     tc::for_each(
-        StripQuotes(tc::explicit_cast<std::string>(jsym->getName())),
+        rngch,
         [&](char c) noexcept {
             if(tc::isasciidigit(c) || tc::isasciilower(c) || tc::isasciiupper(c)) {
                 tc::cont_emplace_back(strResult, c);
@@ -146,6 +150,12 @@ std::string CppifyName(ts::Symbol jsym, ENameContext enamectx) noexcept {
         _ASSERT('_'!=tc_back(strResult));
         tc::append(strResult, "_");
     }
+    return strResult;
+}
+
+// CppifyName returns the user-visible name that we export from namespaces/classes
+std::string CppifyName(ts::Symbol jsym, ENameContext enamectx) noexcept {
+    std::string strResult = CppifyIdentifier(StripQuotes(tc::explicit_cast<std::string>(jsym->getName())));
     _ASSERT(!tc::empty(strResult));
     return MakeUniqueName(jsym, tc_move(strResult), enamectx);
 }
@@ -256,6 +266,18 @@ SMangledType const& SJsVariableLike::MangleType() const& noexcept {
     return *m_omtType;
 }
 
+SMangledType SJsVariableLike::MangleFieldType() const& noexcept {
+    if (static_cast<bool>(ts::SymbolFlags::Optional & m_jsym->getFlags())) {
+        // Keep null, e.g., in `x?: number | null`, getNonNullableType would remove it as well.
+        if (auto const jouniontype = m_jtypeDeclared->isUnion(); jouniontype && !tc::any_of((*jouniontype)->types(), [](ts::Type const jtype) noexcept {
+            return ts::TypeFlags::Null == jtype->flags();
+        })) {
+            return ::MangleType(m_jtypeDeclared->getNonNullableType());
+        }
+    }
+    return MangleType();
+}
+
 SJsFunctionLike::SJsFunctionLike(ts::Symbol jsym, ts::SignatureDeclaration jsigndecl) noexcept
     : m_jsym(jsym)
     , m_strCppifiedName(CppifyName(m_jsym, enamectxFUNCTION))
@@ -293,11 +315,11 @@ std::string SJsFunctionLike::CppifiedParametersWithCommentsDecl() const& noexcep
     });
     return tc::explicit_cast<std::string>(tc::join_separated(
         tc::concat(
-            tc::transform(tc::take(m_vecjsvariablelikeParameters, itjsvariablelike), [](SJsVariableLike const& jsvariablelikeParameter) noexcept {
-                return tc::concat(jsvariablelikeParameter.MangleType().m_strWithComments, " ", jsvariablelikeParameter.m_strCppifiedName);
+            tc::transform(tc::take(m_vecjsvariablelikeParameters, itjsvariablelike), [&](SJsVariableLike const& jsvariablelikeParameter) noexcept {
+                return tc::concat(MangleParameterType(jsvariablelikeParameter).m_strWithComments, " ", jsvariablelikeParameter.m_strCppifiedName);
             }),
-            tc::transform(tc::drop(m_vecjsvariablelikeParameters, itjsvariablelike), [](SJsVariableLike const& jsvariablelikeParameter) noexcept {
-                return tc::concat(jsvariablelikeParameter.MangleType().m_strWithComments, " ", jsvariablelikeParameter.m_strCppifiedName, " = js_undefined()");
+            tc::transform(tc::drop(m_vecjsvariablelikeParameters, itjsvariablelike), [&](SJsVariableLike const& jsvariablelikeParameter) noexcept {
+                return tc::concat(MangleParameterType(jsvariablelikeParameter).m_strWithComments, " ", jsvariablelikeParameter.m_strCppifiedName, " = js_undefined()");
             })
         ),
         ", "
@@ -307,7 +329,7 @@ std::string SJsFunctionLike::CppifiedParametersWithCommentsDecl() const& noexcep
 std::string SJsFunctionLike::CppifiedParametersWithCommentsDef() const& noexcept {
     return tc::explicit_cast<std::string>(tc::join_separated(
         tc::transform(m_vecjsvariablelikeParameters, [&](SJsVariableLike const& jsvariablelikeParameter) noexcept {
-            return tc::concat(jsvariablelikeParameter.MangleType().m_strWithComments, " ", jsvariablelikeParameter.m_strCppifiedName);
+            return tc::concat(MangleParameterType(jsvariablelikeParameter).m_strWithComments, " ", jsvariablelikeParameter.m_strCppifiedName);
         }),
         ", "
     ));
@@ -317,7 +339,7 @@ std::string const& SJsFunctionLike::CanonizedParameterCppTypes() const& noexcept
     if(tc::empty(m_strCanonizedParameterCppTypes)) {
         m_strCanonizedParameterCppTypes = tc::explicit_cast<std::string>(tc::join_separated(
             tc::transform(m_vecjsvariablelikeParameters, [&](SJsVariableLike const& jsvariablelikeParameter) noexcept {
-                return jsvariablelikeParameter.MangleType().m_strCppCanonized;
+                return MangleParameterType(jsvariablelikeParameter).m_strCppCanonized;
             }),
             ", "
         ));
@@ -325,6 +347,19 @@ std::string const& SJsFunctionLike::CanonizedParameterCppTypes() const& noexcept
     return m_strCanonizedParameterCppTypes;
 }
 
+SMangledType SJsFunctionLike::MangleParameterType(SJsVariableLike const& jsvariablelikeParameter) const& noexcept {
+    if(auto const ostrElement = TypedArrayElementType(jsvariablelikeParameter.m_jtypeDeclared)) {
+        // Spans are passed as a view of wasm memory unless the function returns a Promise and may access them later.
+        auto const ojsymReturn = m_jsignature->getReturnType()->getSymbol();
+        bool const bCopy = ojsymReturn && "Promise" == FullyQualifiedName(*ojsymReturn);
+        return {
+            tc::make_str("js_typed_array_param<", *ostrElement, ", /*bCopy*/", (bCopy ? "true" : "false"), ">"),
+            tc::make_str("js_typed_array_param<", *ostrElement, ", ", (bCopy ? "true" : "false"), ">")
+        };
+    }
+    return jsvariablelikeParameter.MangleType();
+}
+
 /*static*/ bool SJsFunctionLike::LessCppSignature(SJsFunctionLike const& a, SJsFunctionLike const& b) noexcept {
     if (a.m_strCppifiedName != b.m_strCppifiedName) {
         return a.m_strCppifiedName < b.m_strCppifiedName;
@@ -338,6 +373,21 @@ SJsClass::SJsClass(ts::Symbol jsym) noexcept
     , m_strCppifiedName(CppifyName(m_jsym, enamectxCLASS))
     , m_strMangledName(MangleSymbolName(m_jsym, enamectxCLASS))
     , m_bHasImplicitDefaultConstructor(false)
+    , m_bHasConstructorValue(false)
+    , m_bSnapshot(tc::any_of(m_jsym->getJsDocTags(), [](ts::JSDocTagInfo jtaginfo) noexcept {
+        return tc::equal(tc::explicit_cast<std::string>(jtaginfo->name()), "tcjsSnapshot");
+    }))
+    , m_bMemoize(
+        tc::any_of(m_jsym->getJsDocTags(), [](ts::JSDocTagInfo jtaginfo) noexcept {
+            return tc::equal(tc::explicit_cast<std::string>(jtaginfo->name()), "tcjsMemoize");
+        })
+        || (!tc::empty(g_vecstrMemoize) && (
+            tc::find_first<tc::return_bool>(g_vecstrMemoize, m_strQualifiedName)
+            || tc::any_of(m_jsym->declarations(), [](ts::Declaration jdecl) noexcept {
+                return tc::find_first<tc::return_bool>(g_vecstrMemoize, tc::explicit_cast<std::string>(jdecl->getSourceFile()->fileName()));
+            })
+        ))
+    )
 {
     SJsScope::Initialize(
         tc_conditional_range(
@@ -384,6 +434,7 @@ SJsClass::SJsClass(ts::Symbol jsym) noexcept
         // See logic at `src/compiler/transformers/es2015.ts`, `addConstructor`, `transformConstructorBody` and `createDefaultConstructorBody`:
         // if no constructrs are defined, we add a "default" constructor with no parameters.
         m_bHasImplicitDefaultConstructor = tc::empty(m_vecjsfunctionlikeCtor);
+        m_bHasConstructorValue = true;
     } else if(static_cast<bool>(ts::SymbolFlags::Interface&m_jsym->getFlags())) {
         // In Typescript, symbols can be "types" or "values". The types do not exist in JavaScript. The values do. 
         // A typescript class is both because the class constructor exists in JavaScript.
@@ -410,7 +461,15 @@ SJsClass::SJsClass(ts::Symbol jsym) noexcept
                                   tc::cont_emplace_back(m_vecjsfunctionlikeCtor, SJsFunctionLike(jsymMember, *ojctorsignature));
                              }
                          });
+                         // Abstract DOM interfaces such as Node cannot be constructed, but still declare a prototype and support instanceof.
+                         // Variables which are not constructors, e.g. `declare var JSON: JSON;`, have neither.
+                         if(tc::equal(tc::explicit_cast<std::string>(jsymMember->getName()), "prototype")) {
+                             m_bHasConstructorValue = true;
+                         }
                     });
+                    if(!tc::empty(m_vecjsfunctionlikeCtor)) {
+                        m_bHasConstructorValue = true;
+                    }
                 }
             }
         }
@@ -441,6 +500,16 @@ SJsClass::SJsClass(ts::Symbol jsym) noexcept
                     });
                 })
             );
+        if(m_bHasImplicitDefaultConstructor) {
+            m_vecjsvariablelikeField = tc::make_vector(tc::transform(
+                tc::filter(jstype->getProperties(), [](ts::Symbol jsymMember) noexcept {
+                    return static_cast<bool>(ts::SymbolFlags::Property & jsymMember->getFlags());
+                }),
+                [](ts::Symbol jsymProperty) noexcept {
+                    return SJsVariableLike(jsymProperty);
+                }
+            ));
+        }
     }
 }
 
@@ -16,6 +16,7 @@ ECppType CppType(tc::js::ts::Symbol jsymType) noexcept;
 tc::ptr_range<char const> StripQuotes(std::string const& str) noexcept;
 
 DEFINE_ENUM(ENameContext, enamectx, (NONE)(ENUM)(CLASS)(TYPEALIAS)(FUNCTION));
+std::string CppifyIdentifier(tc::ptr_range<char const> rngch) noexcept;
 std::string CppifyName(tc::js::ts::Symbol jsymSymbol, ENameContext enamectx) noexcept;
 
 struct SJsEnumOption final {
@@ -69,6 +70,8 @@ public:
     SJsVariableLike& operator=(SJsVariableLike&&) noexcept = default;
 
     SMangledType const& MangleType() const& noexcept;
+    // Type of the property as a field of fields_type. Unset fields are std::nullopt, so undefined is removed from optional properties.
+    SMangledType MangleFieldType() const& noexcept;
 };
 static_assert(std::is_nothrow_move_constructible<SJsVariableLike>::value);
 static_assert(std::is_nothrow_move_assignable<SJsVariableLike>::value);
@@ -84,6 +87,9 @@ private:
     std::string mutable m_strCanonizedParameterCppTypes;
     std::string const& CanonizedParameterCppTypes() const& noexcept;
 
+    // Like SJsVariableLike::MangleType(), but typed array parameters also accept contiguous C++ ranges.
+    SMangledType MangleParameterType(SJsVariableLike const& jsvariablelikeParameter) const& noexcept;
+
 public:
     SJsFunctionLike(tc::js::ts::Symbol jsym, tc::js::ts::SignatureDeclaration jsigndecl) noexcept;
     SJsFunctionLike(SJsFunctionLike&&) noexcept = default;
@@ -139,10 +145,21 @@ struct SJsClass final : public SJsScope, public boost::intrusive::set_base_hook<
     std::vector<SJsFunctionLike> m_vecjsfunctionlikeCtor;
     std::vector<SJsFunctionLike> m_vecjsfunctionlikeMethod;
     std::vector<SJsVariableLike> m_vecjsvariablelikeProperty;
+    // Properties including inherited ones of interfaces constructed from object literals, emitted as fields_type.
+    std::vector<SJsVariableLike> m_vecjsvariablelikeField;
     std::vector<SJsClass const*> m_vecpjsclassBase;
     std::vector<tc::js::ts::Symbol> m_vecjsymBaseUnknown;
 
     bool m_bHasImplicitDefaultConstructor;
+    // The constructor exists as a JS value: classes and interfaces declared together with a variable holding their constructor,
+    // e.g. HTMLElement. Emits _tcjs_constructor(), see tc::jst::js_dynamic_cast.
+    bool m_bHasConstructorValue;
+    // Tagged with the JSDoc tag @tcjsSnapshot: emit snapshot_type, snapshot() and apply_snapshot(), see tc::jst::property_detail::CStructAccessor.
+    bool m_bSnapshot;
+    // Tagged with the JSDoc tag @tcjsMemoize, or the class or its source file is passed to --memoize: getters of readonly
+    // properties and methods without parameters keep the value per JS object after the first read, in JS, see
+    // tc::jst::property_detail::MemoizedProperty. Methods of such classes must not have side effects.
+    bool m_bMemoize;
 
     SJsClass(tc::js::ts::Symbol jsymClass) noexcept;
     SJsClass(SJsClass&&) noexcept = default;
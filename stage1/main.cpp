@@ -15,6 +15,7 @@ using tc::js::ReadonlyArray;
 
 std::optional<ts::TypeChecker> g_ojtsTypeChecker;
 bool g_bGlobalScopeConstructionComplete = true;
+std::vector<std::string> g_vecstrMemoize; // Arguments of --memoize=, see SJsClass::m_bMemoize.
 
 namespace {
 	std::string RetrieveSymbolFromCpp(ts::Symbol jsymSymbol) noexcept {
@@ -31,6 +32,133 @@ namespace {
 		);
 	}
 
+	// Definition of snapshot_type, see SJsClass::m_bSnapshot.
+	std::string SnapshotTypeDefinition(std::string const& strDefinitionsNamespace, std::vector<SJsVariableLike> const& vecjsvariablelikeProperty) noexcept {
+		return tc::make_str(
+			"\tstruct ", strDefinitionsNamespace, "snapshot_type {\n",
+			tc::join(tc::transform(
+				vecjsvariablelikeProperty,
+				[](SJsVariableLike const& jsvariablelikeProperty) noexcept {
+					return tc::concat(
+						"\t\t", jsvariablelikeProperty.MangleType().m_strWithComments, " ", jsvariablelikeProperty.m_strCppifiedName, ";\n"
+					);
+				}
+			)),
+			// Allows passing ranges of snapshots to JS as Array, see tc::jst::struct_detail.
+			"\t\tfriend auto _tcjs_struct_fields(snapshot_type const*) noexcept {\n"
+			"\t\t\treturn std::make_tuple(",
+				tc::join_separated(tc::transform(
+					vecjsvariablelikeProperty,
+					[](SJsVariableLike const& jsvariablelikeProperty) noexcept {
+						return tc::concat("tc::jst::struct_detail::field(\"", jsvariablelikeProperty.m_strJsName, "\", &snapshot_type::", jsvariablelikeProperty.m_strCppifiedName, ")");
+					}
+				), ", "),
+			");\n"
+			"\t\t}\n"
+			"\t};\n"
+		);
+	}
+
+	// Definitions of snapshot() and apply_snapshot(), see SJsClass::m_bSnapshot.
+	std::string SnapshotImpl(std::string const& strClassNamespace, std::vector<SJsVariableLike> const& vecjsvariablelikeProperty) noexcept {
+		auto Accessor = [](auto&& rngjsvariablelike) noexcept {
+			return tc::concat(
+				"\t\tstatic tc::jst::property_detail::CStructAccessor<",
+					tc::join_separated(tc::transform(rngjsvariablelike, [](SJsVariableLike const& jsvariablelike) noexcept {
+						return jsvariablelike.MangleType().m_strWithComments;
+					}), ", "),
+				"> const accessor({",
+					tc::join_separated(tc::transform(rngjsvariablelike, [](SJsVariableLike const& jsvariablelike) noexcept {
+						return tc::concat("\"", jsvariablelike.m_strJsName, "\"");
+					}), ", "),
+				"});\n"
+			);
+		};
+		auto const rngjsvariablelikeWritable = tc::filter(vecjsvariablelikeProperty, [](SJsVariableLike const& jsvariablelike) noexcept {
+			return !jsvariablelike.m_bReadonly;
+		});
+		return tc::make_str(
+			"\tinline auto ", strClassNamespace, "snapshot() noexcept {\n",
+				Accessor(vecjsvariablelikeProperty),
+				"\t\treturn accessor.Read<_tcjs_definitions::snapshot_type>(_getEmval());\n"
+			"\t}\n"
+			"\tinline void ", strClassNamespace, "apply_snapshot(_tcjs_definitions::snapshot_type const& snapshot) noexcept {\n",
+				Accessor(rngjsvariablelikeWritable),
+				"\t\taccessor.Write(_getEmval()",
+					tc::join(tc::transform(rngjsvariablelikeWritable, [](SJsVariableLike const& jsvariablelike) noexcept {
+						return tc::concat(", snapshot.", jsvariablelike.m_strCppifiedName);
+					})),
+				");\n"
+			"\t}\n"
+		);
+	}
+
+	// Getters which are memoized in JS, see SJsClass::m_bMemoize: readonly properties of any type and methods without parameters.
+	bool IsMemoized(SJsClass const& jsclass, SJsVariableLike const& jsvariablelike) noexcept {
+		return jsclass.m_bMemoize && jsvariablelike.m_bReadonly;
+	}
+
+	bool IsMemoized(SJsClass const& jsclass, SJsFunctionLike const& jsfunctionlike) noexcept {
+		return jsclass.m_bMemoize
+			&& tc::empty(jsfunctionlike.m_vecjsvariablelikeParameters)
+			&& ts::TypeFlags::Void != jsfunctionlike.m_jsignature->getReturnType()->flags();
+	}
+
+	// Steps of tc::jst::js_path, see tc::jst::path_detail::STypedStep: all properties, and the methods which are not overloaded.
+	bool HasPathStep(SJsClass const& jsclass, SJsFunctionLike const& jsfunctionlike) noexcept {
+		return !tc::find_first_if<tc::return_bool>(jsclass.m_vecjsfunctionlikeMethod, [&](SJsFunctionLike const& jsfunctionlikeOther) noexcept {
+			return &jsfunctionlikeOther != &jsfunctionlike && jsfunctionlikeOther.m_strCppifiedName == jsfunctionlike.m_strCppifiedName;
+		});
+	}
+
+	std::string PathSteps(SJsClass const& jsclass) noexcept {
+		auto const strObject = tc::concat("_impl", jsclass.m_strMangledName);
+		return tc::make_str(
+			tc::join(tc::transform(jsclass.m_vecjsvariablelikeProperty, [&](SJsVariableLike const& jsvariablelike) noexcept {
+				return tc::concat(
+					"\t\t\t\tusing ", jsvariablelike.m_strCppifiedName, " = tc::jst::path_detail::STypedStep<\"", jsvariablelike.m_strJsName, "\", false, ",
+						strObject, ", ", jsvariablelike.MangleType().m_strWithComments, ">;\n"
+				);
+			})),
+			tc::join(tc::transform(
+				tc::filter(jsclass.m_vecjsfunctionlikeMethod, [&](SJsFunctionLike const& jsfunctionlike) noexcept {
+					return HasPathStep(jsclass, jsfunctionlike);
+				}),
+				[&](SJsFunctionLike const& jsfunctionlike) noexcept {
+					return tc::concat(
+						"\t\t\t\tusing ", jsfunctionlike.m_strCppifiedName, " = tc::jst::path_detail::STypedStep<\"", tc::explicit_cast<std::string>(jsfunctionlike.m_jsym->getName()), "\", true, ",
+							strObject, ", ", MangleType(jsfunctionlike.m_jsignature->getReturnType()).m_strWithComments,
+							tc::join(tc::transform(jsfunctionlike.m_vecjsvariablelikeParameters, [&](SJsVariableLike const& jsvariablelikeParameter) noexcept {
+								return tc::concat(", ", jsfunctionlike.MangleParameterType(jsvariablelikeParameter).m_strWithComments);
+							})),
+						">;\n"
+					);
+				}
+			))
+		);
+	}
+
+	// Definition of _tcjs_construct(fields_type const&), see SJsClass::m_vecjsvariablelikeField.
+	std::string FieldsConstructorImpl(std::string const& strClassNamespace, std::string const& strMangledName, std::vector<SJsVariableLike> const& vecjsvariablelikeField) noexcept {
+		return tc::make_str(
+			"\tinline auto ", strClassNamespace, "_tcjs_construct(_tcjs_definitions::fields_type const& fields) noexcept {\n"
+				"\t\tstatic tc::jst::property_detail::CObjectFactory<",
+					tc::join_separated(tc::transform(vecjsvariablelikeField, [](SJsVariableLike const& jsvariablelike) noexcept {
+						return jsvariablelike.MangleFieldType().m_strWithComments;
+					}), ", "),
+				"> const factory({",
+					tc::join_separated(tc::transform(vecjsvariablelikeField, [](SJsVariableLike const& jsvariablelike) noexcept {
+						return tc::concat("\"", jsvariablelike.m_strJsName, "\"");
+					}), ", "),
+				"});\n"
+				"\t\treturn ", strMangledName, "(factory.Create(",
+					tc::join_separated(tc::transform(vecjsvariablelikeField, [](SJsVariableLike const& jsvariablelike) noexcept {
+						return tc::concat("fields.", jsvariablelike.m_strCppifiedName);
+					}), ", "),
+				"));\n"
+			"\t}\n"
+		);
+	}
 
 	template<typename SetJsXXX, typename Func>
 	std::vector<typename SetJsXXX::value_type const*> SortDeclarationOrder(SetJsXXX& setjs, Func ForEachChild) noexcept {
@@ -57,16 +185,27 @@ namespace {
 SetJsEnum g_setjsenum;
 SetJsClass g_setjsclass;
 SetJsTypeAlias g_setjstypealias;
+std::map<std::string, SJsStringLiteralUnion> g_mapstrjsstrlitunion;
 
 int main(int cArgs, char* apszArgs[]) {
-	_ASSERT(2 <= cArgs);
+	// Options precede the input files: --memoize=<qualified class name or input file> opts into memoized getters.
+	std::string_view const strvMemoize = "--memoize=";
+	int iArgFirstFile = 1;
+	for(; iArgFirstFile < cArgs && std::string_view(apszArgs[iArgFirstFile]).starts_with(strvMemoize); ++iArgFirstFile) {
+		std::string strMemoize(std::string_view(apszArgs[iArgFirstFile]).substr(strvMemoize.size()));
+		tc::for_each(strMemoize, [](char& ch) noexcept {
+			if('\\'==ch) ch = '/'; // Compared to the file names of typescript, like the input files below
+		});
+		tc::cont_emplace_back(g_vecstrMemoize, tc_move(strMemoize));
+	}
+	_ASSERT(iArgFirstFile < cArgs);
 
 	ts::CompilerOptions const jtsCompilerOptions(create_js_object);
 	jtsCompilerOptions->strict(true);
 	jtsCompilerOptions->target(ts::ScriptTarget::ES5);
 	jtsCompilerOptions->module(ts::ModuleKind::CommonJS);
 
-	auto const rngstrFileNames = tc::counted(boost::next(apszArgs), cArgs - 1);
+	auto const rngstrFileNames = tc::counted(apszArgs + iArgFirstFile, cArgs - iArgFirstFile);
 	tc::for_each(rngstrFileNames, [](tc::ptr_range<char> rngch) noexcept {
 		tc::for_each(rngch, [](auto& ch) noexcept { 
 			if('\\'==ch) ch = '/'; // typescript createProgram does not support backslashes 
@@ -104,7 +243,11 @@ int main(int cArgs, char* apszArgs[]) {
 							if (auto const jotsFunctionDeclaration = ts::isFunctionDeclaration(jnodeChild)) {
 								tc::cont_emplace_back(vecjsymExportedSymbol, (*g_ojtsTypeChecker)->getSymbolAtLocation(*(*jotsFunctionDeclaration)->name()));
 							} else if (auto const jotsVariableStatement = ts::isVariableStatement(jnodeChild)) {
-								tc::for_each(tc::js::ts_ext::MakeReadOnlyArray<ts::VariableDeclaration>((*jotsVariableStatement)->declarationList()->declarations()), [&](ts::VariableDeclaration jtsVariableDeclaration) noexcept {
+								auto const junkDeclarations = tc::jst::js_path(*jotsVariableStatement)
+									.step<ts::VariableStatement::_tcjs_path::declarationList>()
+									.step<ts::VariableDeclarationList::_tcjs_path::declarations>()
+									.get();
+								tc::for_each(tc::js::ts_ext::MakeReadOnlyArray<ts::VariableDeclaration>(junkDeclarations), [&](ts::VariableDeclaration jtsVariableDeclaration) noexcept {
 									tc::cont_emplace_back(vecjsymExportedSymbol, (*g_ojtsTypeChecker)->getSymbolAtLocation(jtsVariableDeclaration->name()));
 								});
 							} else if (auto const jotsClassDeclaration = ts::isClassDeclaration(jnodeChild)) {
@@ -297,84 +440,9 @@ int main(int cArgs, char* apszArgs[]) {
 			);
 		};
 
-		tc::append(std::cout,
-			"namespace tc::js_defs {\n",
-			tc::join(tc::transform(g_setjsenum, [](SJsEnum const& jsenumEnum) noexcept {
-				// We have to mark enums as IsJsIntegralEnum before using in js interop.
-				// We have to generate them as enum class even though this is semantically stronger than 
-				// TypeScript enums actually are. Non-class C++ enum options must be globally unique though
-				// and TypeScript enum option names are scoped names like C++ enum class options.
-				return tc::concat(
-					"\tenum class ", jsenumEnum.m_strMangledName, " {\n",
-					tc::join_separated(
-						tc::transform(jsenumEnum.m_vecjsenumoption, [&jsenumEnum](SJsEnumOption const& jsenumoption) noexcept {
-							return tc::concat(
-								"\t\t", jsenumoption.m_strCppifiedName,
-								tc_conditional_range(
-									jsenumEnum.m_bIsIntegral && !std::holds_alternative<std::monostate>(jsenumoption.m_vardblstrValue),
-									tc::concat(" = ", tc::as_dec(tc::explicit_cast<int>(std::get<double>(jsenumoption.m_vardblstrValue))))
-								)
-							);
-						}),
-						",\n"
-					),
-					"\n	};\n"
-				);
-			})),
-			"} // namespace tc::js_defs\n"
-			"namespace tc::jst {\n",
-			tc::join(tc::transform(g_setjsenum, [](SJsEnum const& jsenumEnum) noexcept {
-				// Enums are declared outside of the _jsall class because we have to mark them as IsJsIntegralEnum
-				// before using in js interop.
-				return tc_conditional_range(
-					jsenumEnum.m_bIsIntegral,
-					tc::concat(
-						"\ttemplate<> struct IsJsIntegralEnum<js_defs::", jsenumEnum.m_strMangledName, "> : std::true_type {};\n"
-					),
-					tc::concat(
-						"template<> struct IsJsHeterogeneousEnum<js_defs::", jsenumEnum.m_strMangledName, "> : std::true_type {\n"
-						"\tstatic inline auto const& Values() {\n"
-						"\t\tusing E = js_defs::", jsenumEnum.m_strMangledName, ";\n"
-						"\t\tstatic tc::unordered_map<E, jst::js_unknown> vals{\n",
-						tc::join_separated(
-							tc::transform(
-								tc::filter(
-									jsenumEnum.m_vecjsenumoption, 
-									[](SJsEnumOption const& jsenumoption) noexcept { return !std::holds_alternative<std::monostate>(jsenumoption.m_vardblstrValue); }
-								),
-								[](SJsEnumOption const& jsenumoption) noexcept {
-									return tc::concat(
-										"\t\t\t{E::", jsenumoption.m_strCppifiedName, ", ",
-										tc::visit(jsenumoption.m_vardblstrValue,
-											[](double dblValue) noexcept {
-												// TODO: std::to_string because of floating-point numbers. May be not enough precision.
-												return tc::make_str("js_unknown(", std::to_string(dblValue), ")");
-											},
-											[](std::string const& strValue) noexcept {
-												return tc::make_str("js_string(\"", strValue, "\")");
-											},
-											[](std::monostate const&) noexcept {
-												_ASSERTFALSE;
-												return tc::make_str("");
-											}
-										),
-										"}"
-									);
-								}
-							),
-							",\n"
-						),
-						"\n"
-						"\t\t};\n"
-						"\t\treturn vals;\n"
-						"\t}\n"
-						"};\n"
-					)
-				);
-			})),
-			"} // namespace tc::jst\n"
-			"namespace tc::js_defs {\n"
-			"\tusing namespace jst; // no ADL\n",
+		// MangleType registers unions of string literals in g_mapstrjsstrlitunion, so all code which mangles types
+		// has to be generated before the enum classes for these unions are emitted.
+		std::string const strDefinitions = tc::make_str(
 			tc::join(tc::transform(vecpjsclassSorted, [](SJsClass const* pjsclass) noexcept {
 				return tc::concat(
 					"\tstruct _impl", pjsclass->m_strMangledName, ";\n"
@@ -448,6 +516,22 @@ int main(int cArgs, char* apszArgs[]) {
 							);
 						}
 					)),
+					tc_conditional_range(
+						pjsclass->m_bSnapshot,
+						"\t\t\tstruct snapshot_type;\n"
+					),
+					tc_conditional_range(
+						!tc::empty(pjsclass->m_vecjsvariablelikeField),
+						"\t\t\tstruct fields_type;\n"
+					),
+					tc_conditional_range(
+						!tc::empty(pjsclass->m_vecjsvariablelikeProperty) || !tc::empty(pjsclass->m_vecjsfunctionlikeMethod),
+						tc::concat(
+							"\t\t\tstruct _tcjs_path {\n",
+							PathSteps(*pjsclass),
+							"\t\t\t};\n"
+						)
+					),
 					"\t\t};\n",
 					tc::join(tc::transform(
 						pjsclass->m_vecjsvariablelikeProperty,
@@ -464,6 +548,11 @@ int main(int cArgs, char* apszArgs[]) {
 							);
 						}
 					)),
+					tc_conditional_range(
+						pjsclass->m_bSnapshot,
+						"\t\tauto snapshot() noexcept;\n"
+						"\t\tvoid apply_snapshot(_tcjs_definitions::snapshot_type const& snapshot) noexcept;\n"
+					),
 					tc::join(tc::transform(
 						pjsclass->m_vecjsfunctionlikeCtor,
 						[](SJsFunctionLike const& jsfunctionlike) noexcept {
@@ -476,6 +565,14 @@ int main(int cArgs, char* apszArgs[]) {
 						pjsclass->m_bHasImplicitDefaultConstructor,
 						"\t\tstatic auto _tcjs_construct() noexcept;\n"
 					),
+					tc_conditional_range(
+						!tc::empty(pjsclass->m_vecjsvariablelikeField),
+						"\t\tstatic auto _tcjs_construct(_tcjs_definitions::fields_type const& fields) noexcept;\n"
+					),
+					tc_conditional_range(
+						pjsclass->m_bHasConstructorValue,
+						tc::concat("\t\tstatic emscripten::val const& _tcjs_constructor(std::type_identity<_impl", pjsclass->m_strMangledName, ">) noexcept;\n")
+					),
 					tc::join(tc::transform(
 						pjsclass->m_vecjsfunctionlikeMethod,
 						[](SJsFunctionLike const& jsfunctionlike) noexcept {
@@ -487,6 +584,32 @@ int main(int cArgs, char* apszArgs[]) {
 					"\t};\n"
 				);
 			})),
+			// Nested structs with members of class types are only declared in _tcjs_definitions and defined once all classes
+			// are complete: a member of type js_ref<_implY> instantiates js_ref<_implY>, which derives from _implY::_tcjs_definitions.
+			tc::join(tc::transform(vecpjsclassSorted, [](SJsClass const* pjsclass) noexcept {
+				auto const strDefinitionsNamespace = tc::make_str("_impl", pjsclass->m_strMangledName, "::_tcjs_definitions::");
+				return tc::make_str(
+					tc_conditional_range(
+						pjsclass->m_bSnapshot,
+						SnapshotTypeDefinition(strDefinitionsNamespace, pjsclass->m_vecjsvariablelikeProperty)
+					),
+					tc_conditional_range(
+						!tc::empty(pjsclass->m_vecjsvariablelikeField),
+						tc::concat(
+							"\tstruct ", strDefinitionsNamespace, "fields_type {\n",
+							tc::join(tc::transform(
+								pjsclass->m_vecjsvariablelikeField,
+								[](SJsVariableLike const& jsvariablelikeField) noexcept {
+									return tc::make_str(
+										"\t\tstd::optional<", jsvariablelikeField.MangleFieldType().m_strWithComments, "> ", jsvariablelikeField.m_strCppifiedName, " = std::nullopt;\n"
+									);
+								}
+							)),
+							"\t};\n"
+						)
+					)
+				);
+			})),
 			tc::join(tc::transform(vecpjsclassSorted, [&](SJsClass const* pjsclass) noexcept {
 				auto const strClassNamespace = tc::concat("_impl", pjsclass->m_strMangledName, "::");
 				auto const strClassInstanceRetrieve = RetrieveSymbolFromCpp(pjsclass->m_jsym);
@@ -517,10 +640,18 @@ int main(int cArgs, char* apszArgs[]) {
 					)),
 					tc::join(tc::transform(
 						pjsclass->m_vecjsvariablelikeProperty,
-						[&strClassNamespace](SJsVariableLike const& jsvariablelikeProperty) noexcept {
+						[&pjsclass, &strClassNamespace](SJsVariableLike const& jsvariablelikeProperty) noexcept {
 							return tc::concat(
-								"\tinline auto ", strClassNamespace, jsvariablelikeProperty.m_strCppifiedName, "() noexcept "
-								"{ return _getProperty<", jsvariablelikeProperty.MangleType().m_strWithComments, ">(\"", jsvariablelikeProperty.m_strJsName, "\"); }\n",
+								"\tinline auto ", strClassNamespace, jsvariablelikeProperty.m_strCppifiedName, "() noexcept ",
+								tc_conditional_range(
+									IsMemoized(*pjsclass, jsvariablelikeProperty),
+									tc::concat(
+										"{ return tc::jst::property_detail::MemoizedProperty<", jsvariablelikeProperty.MangleType().m_strWithComments, ", \"", jsvariablelikeProperty.m_strJsName, "\">(_getEmval()); }\n"
+									),
+									tc::concat(
+										"{ return _getProperty<", jsvariablelikeProperty.MangleType().m_strWithComments, ">(\"", jsvariablelikeProperty.m_strJsName, "\"); }\n"
+									)
+								),
 								tc_conditional_range(
 									jsvariablelikeProperty.m_bReadonly,
 									"",
@@ -532,6 +663,10 @@ int main(int cArgs, char* apszArgs[]) {
 							);
 						}
 					)),
+					tc_conditional_range(
+						pjsclass->m_bSnapshot,
+						SnapshotImpl(tc::explicit_cast<std::string>(strClassNamespace), pjsclass->m_vecjsvariablelikeProperty)
+					),
 					tc::join(tc::transform(
 						pjsclass->m_vecjsfunctionlikeCtor,
 						[&pjsclass, &strClassNamespace, &strClassInstanceRetrieve](SJsFunctionLike const& jsfunctionlike) noexcept {
@@ -559,21 +694,40 @@ int main(int cArgs, char* apszArgs[]) {
 							"\t}\n"
 						)
 					),
+					tc_conditional_range(
+						pjsclass->m_bHasConstructorValue,
+						tc::concat(
+							"\tinline emscripten::val const& ", strClassNamespace, "_tcjs_constructor(std::type_identity<_impl", pjsclass->m_strMangledName, ">) noexcept {\n"
+							"\t\tstatic emscripten::val const emvalConstructor = ", strClassInstanceRetrieve, ";\n"
+							"\t\treturn emvalConstructor;\n"
+							"\t}\n"
+						)
+					),
+					tc_conditional_range(
+						!tc::empty(pjsclass->m_vecjsvariablelikeField),
+						FieldsConstructorImpl(tc::explicit_cast<std::string>(strClassNamespace), pjsclass->m_strMangledName, pjsclass->m_vecjsvariablelikeField)
+					),
 					tc::join(tc::transform(
 						pjsclass->m_vecjsfunctionlikeMethod,
-						[&strClassNamespace, &FunctionImpl](SJsFunctionLike const& jsfunctionlike) noexcept {
+						[&pjsclass, &strClassNamespace, &FunctionImpl](SJsFunctionLike const& jsfunctionlike) noexcept {
 							return FunctionImpl(
 								strClassNamespace,
 								[&]() noexcept {
-									return tc::concat("_call<", MangleType(jsfunctionlike.m_jsignature->getReturnType()).m_strWithComments, ">(", 
-										tc::join_separated(
-											tc::concat(
-												tc::single(tc::concat("\"", tc::explicit_cast<std::string>(jsfunctionlike.m_jsym->getName()), "\"")), // FIXME?
-												tc::transform(jsfunctionlike.m_vecjsvariablelikeParameters, TC_MEMBER(.m_strCppifiedName))
-											),
-											", "
-										), 
-										")"
+									return tc_conditional_range(
+										IsMemoized(*pjsclass, jsfunctionlike),
+										tc::concat("tc::jst::property_detail::MemoizedMethod<", MangleType(jsfunctionlike.m_jsignature->getReturnType()).m_strWithComments, ", \"",
+											tc::explicit_cast<std::string>(jsfunctionlike.m_jsym->getName()), "\">(_getEmval())"
+										),
+										tc::concat("_call<", MangleType(jsfunctionlike.m_jsignature->getReturnType()).m_strWithComments, ">(", 
+											tc::join_separated(
+												tc::concat(
+													tc::single(tc::concat("\"", tc::explicit_cast<std::string>(jsfunctionlike.m_jsym->getName()), "\"")), // FIXME?
+													tc::transform(jsfunctionlike.m_vecjsvariablelikeParameters, TC_MEMBER(.m_strCppifiedName))
+												),
+												", "
+											), 
+											")"
+										)
 									);
 								},
 								jsfunctionlike
@@ -581,10 +735,7 @@ int main(int cArgs, char* apszArgs[]) {
 						}
 					))
 				);
-			}))
-		);
-
-		tc::append(std::cout,
+			})),
 			tc::join(tc::transform(
 				scopeGlobal.m_vecjsfunctionlikeExport,
 				[&](SJsFunctionLike const& jsfunctionlike) noexcept {
@@ -607,7 +758,127 @@ int main(int cArgs, char* apszArgs[]) {
 						)
 					);
 				}
-			)),
+			))
+		);
+
+		tc::append(std::cout,
+			"#include \"js_path.h\" // tc::jst::path_detail::STypedStep\n",
+			tc_conditional_range(
+				tc::any_of(g_setjsclass, TC_MEMBER(.m_bMemoize)),
+				"#include \"js_weak.h\" // tc::jst::property_detail::MemoizedProperty\n"
+			),
+			"namespace tc::js_defs {\n",
+			tc::join(tc::transform(g_setjsenum, [](SJsEnum const& jsenumEnum) noexcept {
+				// We have to mark enums as IsJsIntegralEnum before using in js interop.
+				// We have to generate them as enum class even though this is semantically stronger than 
+				// TypeScript enums actually are. Non-class C++ enum options must be globally unique though
+				// and TypeScript enum option names are scoped names like C++ enum class options.
+				return tc::concat(
+					"\tenum class ", jsenumEnum.m_strMangledName, " {\n",
+					tc::join_separated(
+						tc::transform(jsenumEnum.m_vecjsenumoption, [&jsenumEnum](SJsEnumOption const& jsenumoption) noexcept {
+							return tc::concat(
+								"\t\t", jsenumoption.m_strCppifiedName,
+								tc_conditional_range(
+									jsenumEnum.m_bIsIntegral && !std::holds_alternative<std::monostate>(jsenumoption.m_vardblstrValue),
+									tc::concat(" = ", tc::as_dec(tc::explicit_cast<int>(std::get<double>(jsenumoption.m_vardblstrValue))))
+								)
+							);
+						}),
+						",\n"
+					),
+					"\n	};\n"
+				);
+			})),
+			tc::join(tc::transform(g_mapstrjsstrlitunion, [](auto const& kvjsstrlitunion) noexcept {
+				return tc::concat(
+					"\tenum class ", kvjsstrlitunion.second.m_strMangledName, " {\n",
+					tc::join_separated(
+						tc::transform(kvjsstrlitunion.second.m_vecjsstrlitoption, [](SJsStringLiteralOption const& jsstrlitoption) noexcept {
+							return tc::concat("\t\t", jsstrlitoption.m_strCppifiedName);
+						}),
+						",\n"
+					),
+					"\n\t};\n"
+				);
+			})),
+			"} // namespace tc::js_defs\n"
+			"namespace tc::jst {\n",
+			tc::join(tc::transform(g_setjsenum, [](SJsEnum const& jsenumEnum) noexcept {
+				// Enums are declared outside of the _jsall class because we have to mark them as IsJsIntegralEnum
+				// before using in js interop.
+				return tc_conditional_range(
+					jsenumEnum.m_bIsIntegral,
+					tc::concat(
+						"\ttemplate<> struct IsJsIntegralEnum<js_defs::", jsenumEnum.m_strMangledName, "> : std::true_type {};\n"
+					),
+					tc::concat(
+						"template<> struct IsJsHeterogeneousEnum<js_defs::", jsenumEnum.m_strMangledName, "> : std::true_type {\n"
+						"\tstatic inline auto const& Values() {\n"
+						"\t\tusing E = js_defs::", jsenumEnum.m_strMangledName, ";\n"
+						"\t\tstatic tc::unordered_map<E, jst::js_unknown> vals{\n",
+						tc::join_separated(
+							tc::transform(
+								tc::filter(
+									jsenumEnum.m_vecjsenumoption, 
+									[](SJsEnumOption const& jsenumoption) noexcept { return !std::holds_alternative<std::monostate>(jsenumoption.m_vardblstrValue); }
+								),
+								[](SJsEnumOption const& jsenumoption) noexcept {
+									return tc::concat(
+										"\t\t\t{E::", jsenumoption.m_strCppifiedName, ", ",
+										tc::visit(jsenumoption.m_vardblstrValue,
+											[](double dblValue) noexcept {
+												// TODO: std::to_string because of floating-point numbers. May be not enough precision.
+												return tc::make_str("js_unknown(", std::to_string(dblValue), ")");
+											},
+											[](std::string const& strValue) noexcept {
+												return tc::make_str("js_string(\"", strValue, "\")");
+											},
+											[](std::monostate const&) noexcept {
+												_ASSERTFALSE;
+												return tc::make_str("");
+											}
+										),
+										"}"
+									);
+								}
+							),
+							",\n"
+						),
+						"\n"
+						"\t\t};\n"
+						"\t\treturn vals;\n"
+						"\t}\n"
+						"};\n"
+					)
+				);
+			})),
+			tc::join(tc::transform(g_mapstrjsstrlitunion, [](auto const& kvjsstrlitunion) noexcept {
+				// The map is created on first use, so each option's JS string is only created once.
+				return tc::concat(
+					"template<> struct IsJsHeterogeneousEnum<js_defs::", kvjsstrlitunion.second.m_strMangledName, "> : std::true_type {\n"
+					"\tstatic inline auto const& Values() {\n"
+					"\t\tusing E = js_defs::", kvjsstrlitunion.second.m_strMangledName, ";\n"
+					"\t\tstatic tc::unordered_map<E, jst::js_string> vals{\n",
+					tc::join_separated(
+						tc::transform(kvjsstrlitunion.second.m_vecjsstrlitoption, [](SJsStringLiteralOption const& jsstrlitoption) noexcept {
+							return tc::concat(
+								"\t\t\t{E::", jsstrlitoption.m_strCppifiedName, ", js_string(", CppStringLiteral(jsstrlitoption.m_strValue), ")}"
+							);
+						}),
+						",\n"
+					),
+					"\n"
+					"\t\t};\n"
+					"\t\treturn vals;\n"
+					"\t}\n"
+					"};\n"
+				);
+			})),
+			"} // namespace tc::jst\n"
+			"namespace tc::js_defs {\n"
+			"\tusing namespace jst; // no ADL\n",
+			strDefinitions,
 			"}; // namespace tc::js_defs\n"
 			"namespace tc::js {\n"
 		);
@@ -1,5 +1,6 @@
 #include "precompiled.h"
 #include "typescript.d.bootstrap.h"
+#include "js_intern.h"
 #include "mangle.h"
 #include "walk_symbol.h"
 #include "jstypes.h"
@@ -10,7 +11,14 @@ extern std::optional<tc::js::ts::TypeChecker> g_ojtsTypeChecker;
 extern bool g_bGlobalScopeConstructionComplete;
 
 std::string FullyQualifiedName(ts::Symbol jsymType) noexcept {
-	return tc::explicit_cast<std::string>((*g_ojtsTypeChecker)->getFullyQualifiedName(jsymType));
+	// Called for the same symbols over and over again. Looking up the identity of the symbol is a single call into JS,
+	// getFullyQualifiedName would also create the name and convert it to UTF-8 every time.
+	static tc::jst::js_identity_map<ts::Symbol, std::string> s_mapjsymstr;
+	tc::jst::js_identity_id const id = tc::jst::identity_id(jsymType);
+	if(auto const pstr = s_mapjsymstr.find(id)) {
+		return *pstr;
+	}
+	return s_mapjsymstr.try_emplace_with_id(id, jsymType, tc::explicit_cast<std::string>((*g_ojtsTypeChecker)->getFullyQualifiedName(jsymType))).first;
 }
 
 std::optional<ts::TypeReference> IsTypeReference(ts::Type jtypeRoot) noexcept {
@@ -59,8 +67,40 @@ SMangledType WrapType(std::string strPrefix, tc::js::ReadonlyArray<ts::Type> aty
 	};
 }
 
+namespace {
+	// See tc::js::TypedArray in js_bootstrap.h. Uint8ClampedArray has no C++ counterpart.
+	std::optional<std::string> TypedArrayElementTypeByName(std::string const& strTarget) noexcept {
+		static std::map<std::string, std::string> const c_mapstrstrElement{
+			{"Int8Array", "std::int8_t"},
+			{"Uint8Array", "std::uint8_t"},
+			{"Int16Array", "std::int16_t"},
+			{"Uint16Array", "std::uint16_t"},
+			{"Int32Array", "std::int32_t"},
+			{"Uint32Array", "std::uint32_t"},
+			{"Float32Array", "float"},
+			{"Float64Array", "double"}
+		};
+		if(auto const it = c_mapstrstrElement.find(strTarget); it != c_mapstrstrElement.end()) {
+			return it->second;
+		}
+		return std::nullopt;
+	}
+}
+
+std::optional<std::string> TypedArrayElementType(ts::Type jtype) noexcept {
+	if(auto const jointerfacetype = jtype->isClassOrInterface()) {
+		return TypedArrayElementTypeByName(FullyQualifiedName(*(*jointerfacetype)->getSymbol()));
+	}
+	return std::nullopt;
+}
+
 std::optional<SMangledType> MangleBootstrapType(ts::Symbol jsym, tc::jst::js_union<tc::js::ReadonlyArray<ts::Type>, tc::jst::js_undefined> jorarrtypeArguments) noexcept {
-	if(jorarrtypeArguments) {
+	if(!jorarrtypeArguments) {
+		std::string strTarget = FullyQualifiedName(jsym);
+		if(TypedArrayElementTypeByName(strTarget) || "ArrayBuffer" == strTarget || "DataView" == strTarget) {
+			return SMangledType(mangled_no_comments, tc::make_str("js::", strTarget));
+		}
+	} else {
 		std::string strTarget = FullyQualifiedName(jsym);
 		auto const jrarrTypeArguments = *jorarrtypeArguments;
 		if ("Array" == strTarget) {
@@ -75,6 +115,18 @@ std::optional<SMangledType> MangleBootstrapType(ts::Symbol jsym, tc::jst::js_uni
 		} else if ("Record" == strTarget) {
 			_ASSERTEQUAL(jrarrTypeArguments->length(), 2);
 			return WrapType("js::Record<", jrarrTypeArguments, ">");
+		} else if ("Iterable" == strTarget || "IterableIterator" == strTarget) {
+			_ASSERTEQUAL(jrarrTypeArguments->length(), 1);
+			return WrapType("js::Iterable<", jrarrTypeArguments, ">");
+		} else if ("AsyncIterable" == strTarget || "AsyncIterableIterator" == strTarget) {
+			_ASSERTEQUAL(jrarrTypeArguments->length(), 1);
+			return WrapType("js::AsyncIterable<", jrarrTypeArguments, ">");
+		} else if ("Map" == strTarget) {
+			_ASSERTEQUAL(jrarrTypeArguments->length(), 2);
+			return WrapType("js::Map<", jrarrTypeArguments, ">");
+		} else if ("Set" == strTarget) {
+			_ASSERTEQUAL(jrarrTypeArguments->length(), 1);
+			return WrapType("js::Set<", jrarrTypeArguments, ">");
 		}
 	}
 	return std::nullopt;
@@ -92,6 +144,91 @@ SMangledType CommentType(std::string const strCppType, tc::js::ts::Type const jt
 	};
 }
 
+std::string CppStringLiteral(std::string const& str) noexcept {
+	std::string strResult = "\"";
+	tc::for_each(str, [&](char c) noexcept {
+		if('"' == c || '\\' == c) {
+			tc::cont_emplace_back(strResult, '\\');
+			tc::cont_emplace_back(strResult, c);
+		} else if(static_cast<unsigned char>(c) < 0x20) {
+			// Unlike hex escapes, octal escapes end after three digits and cannot swallow the next character.
+			tc::cont_emplace_back(strResult, '\\');
+			tc::cont_emplace_back(strResult, static_cast<char>('0' + (c >> 6)));
+			tc::cont_emplace_back(strResult, static_cast<char>('0' + ((c >> 3) & 7)));
+			tc::cont_emplace_back(strResult, static_cast<char>('0' + (c & 7)));
+		} else {
+			tc::cont_emplace_back(strResult, c); // UTF-8 is passed through
+		}
+	});
+	tc::cont_emplace_back(strResult, '"');
+	return strResult;
+}
+
+namespace {
+	// The name only depends on the set of values, so equal unions in different declarations map to the same C++ type.
+	std::string MangleStringLiteralUnionName(std::vector<std::string> const& vecstrValue) noexcept {
+		std::string strMangled = "_js_lit";
+		tc::for_each(vecstrValue, [&](std::string const& strValue) noexcept {
+			tc::append(strMangled, "_v");
+			tc::for_each(strValue, [&](char c) noexcept {
+				if(tc::isasciidigit(c) || tc::isasciilower(c) || tc::isasciiupper(c)) {
+					tc::cont_emplace_back(strMangled, c);
+				} else if('_' == c) {
+					tc::append(strMangled, "_u");
+				} else {
+					static constexpr char c_achHex[] = "0123456789abcdef";
+					auto const n = static_cast<unsigned char>(c);
+					tc::append(strMangled, "_x");
+					tc::cont_emplace_back(strMangled, c_achHex[n >> 4]);
+					tc::cont_emplace_back(strMangled, c_achHex[n & 0xf]);
+				}
+			});
+		});
+		return strMangled;
+	}
+
+	SMangledType MangleStringLiteralUnion(std::vector<ts::Type> const& vecjtypeLiteral) noexcept {
+		auto vecstrValue = tc::make_vector(tc::transform(vecjtypeLiteral, [](ts::Type const jtypeLiteral) noexcept {
+			return tc::explicit_cast<std::string>(ts::StringLiteralType(jtypeLiteral)->value());
+		}));
+		tc::sort_unique_inplace(vecstrValue, tc::fn_less());
+		auto strMangledName = MangleStringLiteralUnionName(vecstrValue);
+
+		if(auto const [itjsstrlitunion, bInserted] = g_mapstrjsstrlitunion.try_emplace(strMangledName); bInserted) {
+			SJsStringLiteralUnion& jsstrlitunion = itjsstrlitunion->second;
+			jsstrlitunion.m_strMangledName = strMangledName;
+			tc::for_each(vecstrValue, [&](std::string& strValue) noexcept {
+				std::string strName = CppifyIdentifier(tc::as_pointers(strValue));
+				if(tc::empty(strName) || tc::isasciidigit(tc_front(strName))) {
+					strName = tc::make_str("_", strName);
+				}
+				// Different values may map to the same identifier, e.g. "a-b" and "a_b".
+				while(tc::find_first_if<tc::return_bool>(jsstrlitunion.m_vecjsstrlitoption, [&](SJsStringLiteralOption const& jsstrlitoption) noexcept {
+					return jsstrlitoption.m_strCppifiedName == strName;
+				})) {
+					tc::append(strName, "_");
+				}
+				tc::cont_emplace_back(jsstrlitunion.m_vecjsstrlitoption, SJsStringLiteralOption{tc_move(strValue), tc_move(strName)});
+			});
+		}
+
+		return {
+			tc::make_str(
+				strMangledName,
+				" /*",
+				tc::join_separated(
+					tc::transform(vecjtypeLiteral, [](ts::Type const jtypeLiteral) noexcept {
+						return tc::explicit_cast<std::string>((*g_ojtsTypeChecker)->typeToString(jtypeLiteral));
+					}),
+					" | "
+				),
+				"*/"
+			),
+			strMangledName
+		};
+	}
+}
+
 SMangledType MangleType(tc::js::ts::Type jtypeRoot, bool bUseTypeAlias) noexcept {
 	_ASSERT(g_bGlobalScopeConstructionComplete);
 	
@@ -141,13 +278,25 @@ SMangledType MangleType(tc::js::ts::Type jtypeRoot, bool bUseTypeAlias) noexcept
 	}
 	if (auto const jouniontypeRoot = jtypeRoot->isUnion()) {
 		_ASSERT(1 < (*jouniontypeRoot)->types()->length());
-		auto vecmtType = tc::make_vector(tc::transform((*jouniontypeRoot)->types(), [&](ts::Type const jtypeUnionOption) noexcept {
-			return MangleType(jtypeUnionOption);
-		}));
+		std::vector<SMangledType> vecmtType;
+		std::vector<ts::Type> vecjtypeStringLiteral;
+		tc::for_each((*jouniontypeRoot)->types(), [&](ts::Type const jtypeUnionOption) noexcept {
+			if(ts::TypeFlags::StringLiteral == jtypeUnionOption->flags()) {
+				tc::cont_emplace_back(vecjtypeStringLiteral, jtypeUnionOption);
+			} else {
+				tc::cont_emplace_back(vecmtType, MangleType(jtypeUnionOption));
+			}
+		});
 		if(!tc::find_first_if<tc::return_bool>(
 			vecmtType, 
 			[](SMangledType const& mt) noexcept { return tc::equal("js_unknown", mt.m_strCppCanonized); }
 		)) {
+			// A single string literal stays a js_string, multiple ones become an enum class.
+			if(1 == tc::size(vecjtypeStringLiteral)) {
+				tc::cont_emplace_back(vecmtType, MangleType(tc_front(vecjtypeStringLiteral)));
+			} else if(1 < tc::size(vecjtypeStringLiteral)) {
+				tc::cont_emplace_back(vecmtType, MangleStringLiteralUnion(vecjtypeStringLiteral));
+			}
 			// NOTE: sort_unique works with final names which go to C++. It may potentially hide
 			// some errors in mangling (e.g. if two different types map to the same type in C++).
 			tc::sort_unique_inplace(vecmtType, [&](SMangledType const& a, SMangledType const& b) noexcept {
@@ -215,6 +364,9 @@ SMangledType MangleType(tc::js::ts::Type jtypeRoot, bool bUseTypeAlias) noexcept
 		}
 	}
 	if (auto jointerfacetypeRoot = jtypeRoot->isClassOrInterface()) {
+		if(auto const omt = MangleBootstrapType(*(*jointerfacetypeRoot)->getSymbol(), tc::jst::js_undefined())) {
+			return *omt;
+		}
 		if (IsTrivialType(*jointerfacetypeRoot)) {
 			_ASSERTEQUAL((*jointerfacetypeRoot)->flags(), ts::TypeFlags::Object);
 			auto const strName = FullyQualifiedName(*(*jointerfacetypeRoot)->getSymbol());
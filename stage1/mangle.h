@@ -1,7 +1,10 @@
 #pragma once
 
+#include <map>
+#include <optional>
 #include <string>
 #include <utility>
+#include <vector>
 #include "typescript.d.bootstrap.h"
 
 std::string FullyQualifiedName(tc::js::ts::Symbol jsymType) noexcept;
@@ -24,3 +27,25 @@ struct SMangledType {
 };
 
 SMangledType MangleType(tc::js::ts::Type jtypeRoot, bool bUseTypeAlias = true) noexcept;
+
+// C++ element type if jtype is a typed array with a bootstrap counterpart, e.g. "float" for Float32Array.
+std::optional<std::string> TypedArrayElementType(tc::js::ts::Type jtype) noexcept;
+
+
+// Unions of string literals, e.g. "click" | "keydown", are emitted as enum classes marked as IsJsHeterogeneousEnum.
+// The JS strings of the options are created once, so passing an option to JS only copies a handle,
+// and C++ code can only pass the values allowed by the declaration.
+struct SJsStringLiteralOption final {
+	std::string m_strValue;
+	std::string m_strCppifiedName;
+};
+
+struct SJsStringLiteralUnion final {
+	std::string m_strMangledName;
+	std::vector<SJsStringLiteralOption> m_vecjsstrlitoption; // sorted by value
+};
+
+// Indexed by mangled name. Filled by MangleType, so all code has to be generated before the enums are emitted.
+extern std::map<std::string, SJsStringLiteralUnion> g_mapstrjsstrlitunion;
+
+std::string CppStringLiteral(std::string const& str) noexcept;
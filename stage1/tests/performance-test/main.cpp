@@ -1,5 +1,6 @@
 #include "../../precompiled.h"
 #include "MyLib.d.h"
+#include "js_algorithm.h"
 #include <random>
 #include <emscripten/em_asm.h>
 
@@ -80,8 +81,50 @@ int main() {
     });
 
     double const fResultCpp = timed("C++", []() {
+        double fSum = 0.0;
+        tc::for_each(tc::js::MyLib::arr(), [&](double f) noexcept {
+            fSum += f;
+        });
+        return fSum;
+    });
+
+    double const fResultPushdown = timed("C++ pushed down to JS", []() {
+        return tc::jst::sum(tc::js::MyLib::arr());
+    });
+
+    double const fResultAccumulate = timed("C++ tc::accumulate pushed down to JS", []() {
         return tc::accumulate(tc::js::MyLib::arr(), 0.0, fn_assign_plus());
     });
 
     _ASSERT(std::fabs(fResultJs - fResultCpp) < 1e-4);
+    _ASSERT(std::fabs(fResultJs - fResultPushdown) < 1e-4);
+    _ASSERT(std::fabs(fResultJs - fResultAccumulate) < 1e-4);
+
+    {
+        auto const vecf = tc::make_vector(
+            tc::transform(tc::iota(0, 100000), [&](int) noexcept { return static_cast<double>(std::rand())/RAND_MAX; })
+        );
+        std::cout << "===== Create an array of " << tc::size(vecf) << " double values\n";
+
+        double const fResultPush = timed("push per element", [&]() {
+            tc::js::Array<double> jarr(tc::jst::create_js_object);
+            tc::for_each(vecf, [&](double f) noexcept {
+                jarr->push(f);
+            });
+            return tc::accumulate(jarr, 0.0, fn_assign_plus());
+        });
+
+        double const fResultBulk = timed("bulk construction", [&]() {
+            tc::js::Array<double> jarr(tc::jst::create_js_object, vecf);
+            return tc::accumulate(jarr, 0.0, fn_assign_plus());
+        });
+
+        double const fResultAssign = timed("bulk assign", [&]() {
+            tc::js::MyLib::arr()->assign(vecf);
+            return tc::accumulate(tc::js::MyLib::arr(), 0.0, fn_assign_plus());
+        });
+
+        _ASSERT(std::fabs(fResultPush - fResultBulk) < 1e-4);
+        _ASSERT(std::fabs(fResultPush - fResultAssign) < 1e-4);
+    }
 }
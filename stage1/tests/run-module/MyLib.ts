@@ -116,6 +116,14 @@ namespace MyLib {
         return 20;
     }
 
+    export type Direction = "up" | "down" | "left-right";
+
+    export function literalUnionFunction(a: Direction, b: "default" | "new" | undefined): Direction {
+        if (a != "left-right") throw new Error("Invalid left-right");
+        if (b != "new") throw new Error("Invalid new");
+        return "down";
+    }
+
     export function createPromise10(): Promise<number> {
         return new Promise(function(resolve) { resolve(10); });
     }
@@ -124,6 +132,133 @@ namespace MyLib {
         return p.then((x) => x + 1);
     }
 
+    export function sumFloat32Array(arr: Float32Array): number {
+        let sum = 0;
+        for (let i = 0; i < arr.length; ++i) sum += arr[i];
+        return sum;
+    }
+
+    export function sumFloat64ArrayLater(arr: Float64Array): Promise<number> {
+        return new Promise(function(resolve) {
+            setTimeout(function() {
+                let sum = 0;
+                for (let i = 0; i < arr.length; ++i) sum += arr[i];
+                resolve(sum);
+            }, 0);
+        });
+    }
+
+    export function createMap(): Map<string, number> {
+        const map = new Map<string, number>();
+        map.set("a", 1);
+        map.set("b", 2);
+        return map;
+    }
+
+    export function createSet(): Set<number> {
+        const set = new Set<number>();
+        set.add(1);
+        set.add(2);
+        return set;
+    }
+
+    /** @tcjsSnapshot */
+    export interface SnapshotPoint {
+        x: number;
+        y: number;
+        visible: boolean;
+        label: string;
+        readonly owner: SomeObject;
+    }
+
+    export function createSnapshotPoint(): SnapshotPoint {
+        return { x: 1, y: 2, visible: true, label: "first", owner: new SomeObject() };
+    }
+
+    // Snapshot with a member of its own type, which is only complete after the class has been defined.
+    /** @tcjsSnapshot */
+    export interface SnapshotTreeNode {
+        value: number;
+        readonly root: SnapshotTreeNode;
+    }
+
+    export function createSnapshotTreeNode(): SnapshotTreeNode {
+        const node = { value: 5, root: undefined as unknown as SnapshotTreeNode };
+        node.root = node;
+        return node;
+    }
+
+    export function sumSnapshotPointX(points: SnapshotPoint[]): number {
+        return points.reduce((sum, pt) => sum + pt.x, 0);
+    }
+
+    /** @tcjsMemoize */
+    export interface MemoizedObject {
+        readonly owner: SomeObject;
+        readonly items: number[];
+        readonly name: string;
+        count: number;
+        getLabel(): string;
+        getLabelWithSuffix(suffix: string): string;
+    }
+
+    export var memoizedOwnerReads: number = 0;
+    export var memoizedNameReads: number = 0;
+    export var memoizedLabelCalls: number = 0;
+    export function createMemoizedObject(): MemoizedObject {
+        const owner = new SomeObject();
+        return {
+            get owner() {
+                ++memoizedOwnerReads;
+                return owner;
+            },
+            items: [1, 2, 3],
+            get name() {
+                ++memoizedNameReads;
+                return "memoized";
+            },
+            count: 1,
+            getLabel() {
+                ++memoizedLabelCalls;
+                return "label";
+            },
+            getLabelWithSuffix(suffix: string) {
+                ++memoizedLabelCalls;
+                return "label" + suffix;
+            }
+        };
+    }
+
+    export interface PathNode {
+        readonly name: string;
+        readonly next: PathNode | undefined;
+        child(i: number): PathNode;
+    }
+
+    export var pathNodeChildCalls: number = 0;
+    export function createPathNode(name: string, next: PathNode | undefined): PathNode {
+        return {
+            name: name,
+            next: next,
+            child(i: number) {
+                ++pathNodeChildCalls;
+                return createPathNode(name + "/" + i, 0 === i % 2 ? createPathNode(name + "/" + i + "/next", undefined) : undefined);
+            }
+        };
+    }
+
+    export interface AggregateOptions {
+        name?: string;
+        count?: number;
+        enabled?: boolean;
+        tags?: string[];
+        child?: AggregateOptions; // fields_type has a member of its own class type
+    }
+
+    export function stringifyAggregateOptions(options: AggregateOptions): string {
+        return JSON.stringify(options);
+    }
+
     var promiseCompleted = false;
     export function completePromiseTest() {
         promiseCompleted = true;
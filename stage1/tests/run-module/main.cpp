@@ -18,6 +18,15 @@ int main() {
 	_ASSERT(objBase.getEmval().strictlyEquals(obj.getEmval()));
 	_ASSERTEQUAL(tc::explicit_cast<std::string>(objBase->foo(10)), "foo() retval number 10");
 
+	{
+		auto const oobj = tc::jst::js_dynamic_cast<tc::js::MyLib::SomeObject>(objBase);
+		_ASSERT(oobj && oobj->getEmval().strictlyEquals(obj.getEmval()));
+		tc::js::MyLib::SomeBaseClass objBaseOnly(tc::jst::create_js_object);
+		_ASSERT(!tc::jst::js_dynamic_cast<tc::js::MyLib::SomeObject>(objBaseOnly));
+		_ASSERT(!tc::jst::js_dynamic_cast<tc::js::MyLib::SomeObjectWithConstructor>(objBase));
+		_ASSERT(tc::jst::js_dynamic_cast<tc::js::MyLib::SomeBaseClass>(obj));
+	}
+
 	tc::js::MyLib::SomeObjectWithConstructor objConstr(tc::jst::create_js_object, 10, 20);
 	_ASSERTEQUAL(tc::explicit_cast<std::string>(objConstr->str()), "30");
 
@@ -80,6 +89,12 @@ int main() {
 
 	_ASSERTEQUAL(tc::js::MyLib::literalTypesFunction(10, tc::jst::js_string("str")), 20);
 
+	static_assert(std::is_enum<tc::js::MyLib::Direction>::value);
+	_ASSERTEQUAL(
+		tc::js::MyLib::literalUnionFunction(tc::js::MyLib::Direction::left_right, tc::js_defs::_js_lit_vdefault_vnew::new_),
+		tc::js::MyLib::Direction::down
+	);
+
 	{
 		tc::js::Promise<double> p1 = tc::js::MyLib::createPromise10();
 		tc::js::Promise<double> p2 = tc::js::MyLib::increasePromiseValue(p1);
@@ -91,6 +106,132 @@ int main() {
 		tc::js::Promise<void> p3 = p2->then(l2);
 	}
 
+	{
+		std::vector<float> vecflt{1, 2, 3.5};
+		_ASSERTEQUAL(tc::js::MyLib::sumFloat32Array(vecflt), 6.5);
+		_ASSERTEQUAL(tc::js::MyLib::sumFloat32Array(tc::js::Float32Array(tc::jst::create_js_object, std::span<float const>(vecflt))), 6.5);
+
+		// The function returns a Promise, so it receives a copy which stays valid after vecdbl is gone.
+		std::vector<double> vecdbl{1, 2};
+		tc::js::Promise<double> p = tc::js::MyLib::sumFloat64ArrayLater(vecdbl);
+		vecdbl = std::vector<double>{10, 20};
+		static auto l = tc::jst::js_lambda_wrap([](double x) noexcept {
+			_ASSERTEQUAL(x, 3);
+		});
+		p->then(l);
+	}
+
+	{
+		tc::js::Map<tc::jst::js_string, double> jmap = tc::js::MyLib::createMap();
+		_ASSERTEQUAL(jmap->size(), 2);
+		_ASSERT(jmap->has(tc::jst::js_string("a")));
+		_ASSERT(!jmap->get(tc::jst::js_string("c")));
+		jmap->set(tc::jst::js_string("c"), 3);
+		auto const vecpairstrdbl = jmap->entries_snapshot();
+		_ASSERT(3 == vecpairstrdbl.size());
+		_ASSERTEQUAL(tc::explicit_cast<std::string>(vecpairstrdbl[2].first), "c");
+		_ASSERTEQUAL(vecpairstrdbl[2].second, 3);
+
+		tc::js::Set<double> jset = tc::js::MyLib::createSet();
+		jset->add(3);
+		_ASSERT(jset->delete_(1));
+		_ASSERT((std::vector<double>{2, 3}) == jset->values_snapshot());
+	}
+
+	{
+		tc::js::MyLib::SnapshotPoint jpt = tc::js::MyLib::createSnapshotPoint();
+		tc::js::MyLib::SnapshotPoint::snapshot_type pt = jpt->snapshot();
+		_ASSERTEQUAL(pt.x, 1);
+		_ASSERTEQUAL(pt.y, 2);
+		_ASSERT(pt.visible);
+		_ASSERTEQUAL(tc::explicit_cast<std::string>(pt.label), "first");
+		_ASSERTEQUAL(tc::explicit_cast<std::string>(pt.owner->foo(1)), "foo() retval number 1");
+
+		pt.x = 3;
+		pt.visible = false;
+		pt.label = tc::jst::js_string("second");
+		jpt->apply_snapshot(pt);
+		_ASSERTEQUAL(jpt->x(), 3);
+		_ASSERTEQUAL(jpt->y(), 2);
+		_ASSERT(!jpt->visible());
+		_ASSERTEQUAL(tc::explicit_cast<std::string>(jpt->label()), "second");
+
+		// Snapshots are packed into wasm memory and decoded into JS objects with a single call.
+		std::vector<tc::js::MyLib::SnapshotPoint::snapshot_type> vecpt{pt, jpt->snapshot()};
+		vecpt[1].x = 4;
+		_ASSERTEQUAL(tc::js::MyLib::sumSnapshotPointX(tc::js::Array<tc::js::MyLib::SnapshotPoint>(tc::jst::create_js_object, vecpt)), 7);
+	}
+
+	{
+		// Readonly properties and methods without parameters of @tcjsMemoize classes are read from JS once per object.
+		tc::js::MyLib::MemoizedObject jmemo = tc::js::MyLib::createMemoizedObject();
+		tc::js::MyLib::SomeObject jobjOwner = jmemo->owner();
+		_ASSERT(jmemo->owner().getEmval().strictlyEquals(jobjOwner.getEmval()));
+		_ASSERTEQUAL(tc::js::MyLib::memoizedOwnerReads(), 1);
+		_ASSERTEQUAL(jmemo->items()->length(), 3);
+		_ASSERTEQUAL(tc::explicit_cast<std::string>(jmemo->name()), "memoized");
+		_ASSERTEQUAL(tc::explicit_cast<std::string>(jmemo->name()), "memoized");
+		_ASSERTEQUAL(tc::js::MyLib::memoizedNameReads(), 1);
+		_ASSERTEQUAL(tc::explicit_cast<std::string>(jmemo->getLabel()), "label");
+		_ASSERTEQUAL(tc::explicit_cast<std::string>(jmemo->getLabel()), "label");
+		_ASSERTEQUAL(tc::js::MyLib::memoizedLabelCalls(), 1);
+		// Methods with parameters and writable properties are not memoized.
+		_ASSERTEQUAL(tc::explicit_cast<std::string>(jmemo->getLabelWithSuffix(tc::jst::js_string("!"))), "label!");
+		_ASSERTEQUAL(tc::explicit_cast<std::string>(jmemo->getLabelWithSuffix(tc::jst::js_string("?"))), "label?");
+		_ASSERTEQUAL(tc::js::MyLib::memoizedLabelCalls(), 3);
+		jmemo->count(2);
+		_ASSERTEQUAL(jmemo->count(), 2);
+
+		// The values are stored per JS object, not per js_ref.
+		tc::js::MyLib::MemoizedObject jmemoCopy(jmemo.getEmval());
+		_ASSERT(jmemoCopy->owner().getEmval().strictlyEquals(jobjOwner.getEmval()));
+		_ASSERTEQUAL(tc::js::MyLib::memoizedOwnerReads(), 1);
+		tc::js::MyLib::MemoizedObject jmemoOther = tc::js::MyLib::createMemoizedObject();
+		_ASSERT(!jmemoOther->owner().getEmval().strictlyEquals(jobjOwner.getEmval()));
+		_ASSERTEQUAL(tc::js::MyLib::memoizedOwnerReads(), 2);
+	}
+
+	{
+		using PathStep = tc::js::MyLib::PathNode::_tcjs_path;
+		tc::js::MyLib::PathNode jnode = tc::js::MyLib::createPathNode(tc::jst::js_string("root"), tc::js::MyLib::createPathNode(tc::jst::js_string("root/next"), tc::jst::js_undefined()));
+		_ASSERTEQUAL(tc::explicit_cast<std::string>(tc::jst::js_path(jnode).step<PathStep::name>().get()), "root");
+		_ASSERTEQUAL(tc::explicit_cast<std::string>(tc::jst::js_path(jnode).step<PathStep::child>(3.0).step<PathStep::name>().get()), "root/3");
+		_ASSERTEQUAL(tc::js::MyLib::pathNodeChildCalls(), 1);
+
+		// next is optional, so the chain returns undefined instead of reading name of undefined.
+		tc::jst::js_optional<tc::jst::js_string> ostrNext = tc::jst::js_path(jnode).step<PathStep::child>(3.0).step<PathStep::next>().step<PathStep::name>().get();
+		_ASSERT(ostrNext.getEmval().isUndefined());
+		ostrNext = tc::jst::js_path(jnode).step<PathStep::child>(2.0).step<PathStep::next>().step<PathStep::name>().get();
+		_ASSERTEQUAL(tc::explicit_cast<std::string>(*ostrNext), "root/2/next");
+		_ASSERTEQUAL(tc::explicit_cast<std::string>(*tc::jst::js_path(jnode).step<PathStep::next>().step<PathStep::name>().get()), "root/next");
+		_ASSERTEQUAL(tc::js::MyLib::pathNodeChildCalls(), 3);
+	}
+
+	{
+		tc::js::MyLib::SnapshotTreeNode jnode = tc::js::MyLib::createSnapshotTreeNode();
+		tc::js::MyLib::SnapshotTreeNode::snapshot_type node = jnode->snapshot();
+		_ASSERTEQUAL(node.value, 5);
+		_ASSERT(node.root.getEmval().strictlyEquals(jnode.getEmval()));
+	}
+
+	{
+		// Unset fields are not created on the JS object.
+		tc::js::MyLib::AggregateOptions jopt(tc::jst::create_js_object, tc::js::MyLib::AggregateOptions::fields_type{
+			.name = tc::jst::js_string("a"),
+			.enabled = false
+		});
+		_ASSERTEQUAL(tc::explicit_cast<std::string>(tc::js::MyLib::stringifyAggregateOptions(jopt)), "{\"name\":\"a\",\"enabled\":false}");
+
+		tc::js::MyLib::AggregateOptions joptEmpty(tc::jst::create_js_object, tc::js::MyLib::AggregateOptions::fields_type{});
+		_ASSERTEQUAL(tc::explicit_cast<std::string>(tc::js::MyLib::stringifyAggregateOptions(joptEmpty)), "{}");
+
+		tc::js::MyLib::AggregateOptions joptParent(tc::jst::create_js_object, tc::js::MyLib::AggregateOptions::fields_type{
+			.count = 2,
+			.child = jopt
+		});
+		_ASSERTEQUAL(tc::explicit_cast<std::string>(tc::js::MyLib::stringifyAggregateOptions(joptParent)), "{\"count\":2,\"child\":{\"name\":\"a\",\"enabled\":false}}");
+	}
+
 	tc::jst::js_optional<tc::js::MyLib::AmbientTest>{};
 	tc::jst::js_optional<tc::js::MyLib::AmbientTest::AmbientNested>{};
 